@@ -0,0 +1,289 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <source_location>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Запоминает итоговые размеры векторов по местам их создания.
+ * @details Для каждого места создания хранится выученная вместимость. Уничтоженный вектор
+ * сообщает свой размер: если он больше выученного, выученная вместимость сразу
+ * увеличивается до него, иначе плавно уменьшается на четверть разницы, чтобы один
+ * большой выброс не заставлял вечно резервировать лишнее. Места создания различаются по
+ * имени файла, строке и позиции; имя файла сравнивается по содержимому, потому что в разных
+ * единицах трансляции одна и та же строка может лежать по разным адресам. Счётчики
+ * атомарны, а поиск места выполняется через кэш текущего потока, так что блокировка
+ * берётся только при первом создании вектора в этом месте в этом потоке.
+ */
+class CapacityLearner {
+public:
+    //! Наибольшая вместимость в байтах, которую имеет смысл резервировать заранее.
+    static constexpr size_t MAX_LEARNED_BYTES = size_t{1} << 26U;
+
+    //! Запрет на копирование.
+    CapacityLearner(const CapacityLearner &) = delete;
+    //! Запрет на копирование.
+    CapacityLearner &operator=(const CapacityLearner &) = delete;
+
+    /**
+     * @brief Получает объект программы.
+     * @return объект.
+     */
+    static CapacityLearner &Instance() noexcept;
+
+    /**
+     * @brief Получает счётчик выученной вместимости места создания.
+     * @param site Место создания.
+     * @return счётчик, живущий до завершения программы.
+     */
+    std::atomic<size_t> &Slot(const std::source_location &site);
+
+    /**
+     * @brief Учитывает итоговый размер вектора.
+     * @param slot Счётчик места создания.
+     * @param size Размер вектора перед уничтожением.
+     * @param element_size Размер элемента в байтах.
+     */
+    static void Learn(std::atomic<size_t> &slot, size_t size, size_t element_size) noexcept;
+
+    /**
+     * @brief Получает выученную вместимость места создания.
+     * @param site Место создания.
+     * @return вместимость в элементах.
+     */
+    [[nodiscard]] size_t LearnedCapacity(const std::source_location &site);
+
+    /**
+     * @brief Забывает все выученные вместимости.
+     */
+    void Reset() noexcept;
+
+private:
+    //! Ключ места создания: имя файла, строка и позиция в строке.
+    using Key = std::tuple<std::string_view, uint_least32_t, uint_least32_t>;
+
+    /**
+     * @brief Хэш ключа места создания.
+     */
+    struct KeyHash {
+        //! Вычисляет хэш.
+        size_t operator()(const Key &key) const noexcept {
+            const size_t file = std::hash<std::string_view>{}(std::get<0>(key));
+            return file ^ ((static_cast<size_t>(std::get<1>(key)) << 16U) + std::get<2>(key));
+        }
+    };
+
+    std::mutex mutex_; //!< Защищает slots_.
+    std::map<Key, std::unique_ptr<std::atomic<size_t>>> slots_; //!< Счётчики мест создания.
+
+    CapacityLearner() = default;
+};
+
+/**
+ * @brief Вектор, заранее резервирующий вместимость, выученную в месте его создания.
+ * @details Каждый созданный вектор резервирует столько элементов, сколько обычно оказывалось
+ * в векторах, созданных в том же месте программы, а при уничтожении сообщает свой размер.
+ * Так повторяющиеся построения векторов похожего размера обходятся одним выделением памяти
+ * без ручного вызова Reserve. Вектор, из которого переместили содержимое, размер не сообщает.
+ * Vector не имеет виртуального деструктора, поэтому наследование закрытое: AdaptiveVector
+ * нельзя уничтожить через указатель на Vector, а интерфейс вектора открыт using-объявлениями.
+ * @tparam T Тип элемента вектора.
+ * @tparam Allocator Тип аллокатора.
+ * @tparam GrowthPolicy Стратегия роста вместимости.
+ * @see CapacityLearner
+ */
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class AdaptiveVector : private Vector<T, Allocator, GrowthPolicy> {
+public:
+    using Base = Vector<T, Allocator, GrowthPolicy>; //!< Тип вектора.
+    using typename Base::allocator_type;
+    using typename Base::iterator;
+    using typename Base::const_iterator;
+
+    // Интерфейс Vector открывается целиком, кроме Swap, который принимает только AdaptiveVector
+    using Base::begin;
+    using Base::cbegin;
+    using Base::end;
+    using Base::cend;
+    using Base::Reserve;
+    using Base::Resize;
+    using Base::ShrinkToFit;
+    using Base::Clear;
+    using Base::ResizeDefaultInit;
+    using Base::PushBack;
+    using Base::PopBack;
+    using Base::EmplaceBack;
+    using Base::Insert;
+    using Base::Emplace;
+    using Base::Append;
+    using Base::Erase;
+    using Base::EraseIf;
+    using Base::EraseIndices;
+    using Base::Size;
+    using Base::Capacity;
+    using Base::operator[];
+    using Base::GetAllocator;
+
+    /**
+     * @brief Конструирует пустой вектор с выученной вместимостью.
+     * @param site Место создания.
+     */
+    explicit AdaptiveVector(const std::source_location &site = std::source_location::current());
+
+    /**
+     * @brief Конструирует пустой вектор с указанным аллокатором и выученной вместимостью.
+     * @param alloc Аллокатор.
+     * @param site Место создания.
+     */
+    explicit AdaptiveVector(const Allocator &alloc, const std::source_location &site = std::source_location::current());
+
+    /**
+     * @brief Конструирует объект, копируя переданный; место создания берётся у него.
+     * @param other Объект для копирования.
+     */
+    AdaptiveVector(const AdaptiveVector &other) = default;
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @param other Объект для перемещения, больше не сообщающий свой размер.
+     */
+    AdaptiveVector(AdaptiveVector &&other) noexcept;
+
+    /**
+     * @brief Присваивает объект, копируя себе содержимое переданного; место создания не меняется.
+     * @param rhs Объект для копирования.
+     * @return текущий объект.
+     */
+    AdaptiveVector &operator=(const AdaptiveVector &rhs);
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @param rhs Объект для перемещения, больше не сообщающий свой размер.
+     * @return текущий объект.
+     */
+    AdaptiveVector &operator=(AdaptiveVector &&rhs) noexcept(noexcept(std::declval<Base &>() = std::declval<Base>()));
+
+    /**
+     * @brief Обменивает содержимое; каждый вектор по-прежнему сообщает размер своему месту создания.
+     * @param other Вектор для обмена.
+     */
+    void Swap(AdaptiveVector &other) noexcept;
+
+    /**
+     * @brief Сообщает размер месту создания.
+     */
+    ~AdaptiveVector();
+
+private:
+    std::atomic<size_t> *slot_; //!< Счётчик места создания, nullptr если размер не сообщается.
+};
+
+inline CapacityLearner &CapacityLearner::Instance() noexcept {
+    static CapacityLearner learner;
+    return learner;
+}
+
+inline std::atomic<size_t> &CapacityLearner::Slot(const std::source_location &site) {
+    const Key key{site.file_name(), site.line(), site.column()};
+    thread_local std::unordered_map<Key, std::atomic<size_t> *, KeyHash> cache;
+    const auto cached = cache.find(key);
+    if (cached != cache.end()) {
+        return *cached->second;
+    }
+    std::atomic<size_t> *slot = nullptr;
+    {
+        const std::lock_guard lock(mutex_);
+        std::unique_ptr<std::atomic<size_t>> &owner = slots_[key];
+        if (owner == nullptr) {
+            owner = std::make_unique<std::atomic<size_t>>(0U);
+        }
+        slot = owner.get();
+    }
+    cache.emplace(key, slot);
+    return *slot;
+}
+
+inline void CapacityLearner::Learn(std::atomic<size_t> &slot, const size_t size, const size_t element_size) noexcept {
+    const size_t observed = std::min(size, MAX_LEARNED_BYTES / element_size);
+    size_t learned = slot.load(std::memory_order_relaxed);
+    size_t updated = 0U;
+    do {
+        updated = (observed >= learned) ? observed : learned - (learned - observed + 3U) / 4U;
+    } while (updated != learned
+             && !slot.compare_exchange_weak(learned, updated, std::memory_order_relaxed));
+}
+
+inline size_t CapacityLearner::LearnedCapacity(const std::source_location &site) {
+    return Slot(site).load(std::memory_order_relaxed);
+}
+
+inline void CapacityLearner::Reset() noexcept {
+    // Счётчики не удаляются: на них ссылаются живые векторы и кэши потоков
+    const std::lock_guard lock(mutex_);
+    for (auto &[key, slot] : slots_) {
+        slot->store(0U, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+AdaptiveVector<T, Allocator, GrowthPolicy>::AdaptiveVector(const std::source_location &site)
+: AdaptiveVector(Allocator(), site) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+AdaptiveVector<T, Allocator, GrowthPolicy>::AdaptiveVector(const Allocator &alloc, const std::source_location &site)
+: Base(alloc)
+, slot_(&CapacityLearner::Instance().Slot(site)) {
+    const size_t learned = slot_->load(std::memory_order_relaxed);
+    if (learned != 0U) {
+        Base::Reserve(learned);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+AdaptiveVector<T, Allocator, GrowthPolicy>::AdaptiveVector(AdaptiveVector &&other) noexcept
+: Base(std::move(other))
+, slot_(std::exchange(other.slot_, nullptr)) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+AdaptiveVector<T, Allocator, GrowthPolicy> &AdaptiveVector<T, Allocator, GrowthPolicy>::operator=(const AdaptiveVector &rhs) {
+    Base::operator=(rhs);
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+AdaptiveVector<T, Allocator, GrowthPolicy> &AdaptiveVector<T, Allocator, GrowthPolicy>::operator=(AdaptiveVector &&rhs)
+    noexcept(noexcept(std::declval<Base &>() = std::declval<Base>())) {
+    if (this != &rhs) {
+        Base::operator=(std::move(rhs));
+        // rhs остался пустым, его размер ничего не значит
+        rhs.slot_ = nullptr;
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+void AdaptiveVector<T, Allocator, GrowthPolicy>::Swap(AdaptiveVector &other) noexcept {
+    Base::Swap(other);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy>
+AdaptiveVector<T, Allocator, GrowthPolicy>::~AdaptiveVector() {
+    if (slot_ != nullptr) {
+        CapacityLearner::Learn(*slot_, Base::Size(), sizeof(T));
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+//! Размер кэш-линии, к которому по умолчанию выравнивается AlignedVector.
+inline constexpr size_t CACHE_LINE_SIZE = 64U;
+
+/**
+ * @brief Аллокатор, выравнивающий начало каждого блока по указанной границе.
+ * @details Использует выровненные operator new / operator delete с передачей размера.
+ * Фактическое выравнивание - наибольшее из Align и alignof(T), поэтому аллокатор корректен
+ * и для сверхвыровненных типов.
+ * @tparam T Тип объекта, который будет размещаться в памяти.
+ * @tparam Align Требуемое выравнивание в байтах, степень двойки.
+ */
+template <typename T, size_t Align = CACHE_LINE_SIZE>
+class AlignedAllocator {
+public:
+    using value_type = T; //!< Тип объекта.
+    using is_always_equal = std::true_type; //!< Аллокатор не имеет состояния.
+
+    //! Фактическое выравнивание блоков.
+    static constexpr size_t ALIGNMENT = std::max(Align, alignof(T));
+
+    static_assert((Align & (Align - 1U)) == 0U, "Alignment must be a power of two");
+
+    /**
+     * @brief Аллокатор для другого типа с тем же выравниванием.
+     * @tparam U Тип объекта.
+     */
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>; //!< Тип аллокатора.
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    //! Конструктор преобразования из аллокатора для другого типа.
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> & /*other*/) noexcept {  // NOLINT
+    }
+
+    /**
+     * @brief Выделяет выровненную сырую память под указанное количество элементов.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     */
+    T *allocate(size_t n);
+
+    /**
+     * @brief Освобождает память, выделенную ранее при помощи allocate.
+     * @param p Указатель на память.
+     * @param n Количество элементов, под которое выделялась память.
+     */
+    void deallocate(T *p, size_t n) noexcept;
+
+    //! Все экземпляры взаимозаменяемы.
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align> & /*other*/) const noexcept {
+        return true;
+    }
+};
+
+/**
+ * @brief Вектор, начало памяти которого выровнено по указанной границе.
+ * @details Подходит для векторизованных циклов с выровненными загрузками: по умолчанию
+ * буфер начинается на границе кэш-линии, что совпадает с шириной регистра AVX-512.
+ * @tparam T Тип элемента вектора.
+ * @tparam Align Требуемое выравнивание в байтах.
+ */
+template <typename T, size_t Align = CACHE_LINE_SIZE>
+using AlignedVector = Vector<T, AlignedAllocator<T, Align>>;
+
+template <typename T, size_t Align>
+T *AlignedAllocator<T, Align>::allocate(const size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    return static_cast<T *>(operator new(n * sizeof(T), std::align_val_t{ALIGNMENT}));
+}
+
+template <typename T, size_t Align>
+void AlignedAllocator<T, Align>::deallocate(T *const p, const size_t n) noexcept {
+    operator delete(p, n * sizeof(T), std::align_val_t{ALIGNMENT});
+}
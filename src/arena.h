@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Монотонная арена: выделяет память сдвигом указателя и освобождает её только целиком.
+ * @details Память берётся у operator new крупными кусками, каждый следующий вдвое больше
+ * предыдущего. Освобождение отдельных блоков ничего не делает, вся память возвращается
+ * при вызове Release или в деструкторе. Последний выделенный блок можно расширить на месте,
+ * если в текущем куске хватает места, - так растущий вектор в арене обходится без копирования.
+ * Арена не потокобезопасна.
+ */
+class MonotonicArena {
+public:
+    //! Размер первого куска по умолчанию.
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 4096U;
+
+    /**
+     * @brief Конструирует арену без выделенной памяти.
+     * @param initial_chunk_bytes Размер первого куска в байтах.
+     */
+    explicit MonotonicArena(size_t initial_chunk_bytes = DEFAULT_CHUNK_BYTES) noexcept;
+
+    //! Запрет на копирование.
+    MonotonicArena(const MonotonicArena &) = delete;
+    //! Запрет на копирование.
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    /**
+     * @brief Освобождает всю память арены.
+     */
+    ~MonotonicArena();
+
+    /**
+     * @brief Выделяет блок памяти.
+     * @param bytes Размер блока в байтах.
+     * @param alignment Выравнивание блока.
+     * @return указатель на начало блока.
+     */
+    void *Allocate(size_t bytes, size_t alignment);
+
+    /**
+     * @brief Пытается расширить блок на месте.
+     * @details Возможно только для последнего выделенного блока, за которым в текущем
+     * куске есть достаточно свободного места.
+     * @param p Указатель на блок.
+     * @param old_bytes Текущий размер блока в байтах.
+     * @param new_bytes Новый размер блока в байтах.
+     * @return true, если блок расширен.
+     */
+    bool Expand(void *p, size_t old_bytes, size_t new_bytes) noexcept;
+
+    /**
+     * @brief Освобождает всю память арены разом.
+     * @warning Все указатели, полученные из арены, становятся недействительными.
+     */
+    void Release() noexcept;
+
+    /**
+     * @brief Получает количество байт, выданных арене у operator new.
+     * @return размер всех кусков в байтах.
+     */
+    [[nodiscard]] size_t ReservedBytes() const noexcept;
+
+private:
+    /**
+     * @brief Заголовок куска памяти, куски связаны в список.
+     */
+    struct Chunk {
+        Chunk *prev = nullptr; //!< Предыдущий кусок.
+        size_t bytes = 0U; //!< Размер куска вместе с заголовком.
+    };
+
+    Chunk *chunk_ = nullptr; //!< Текущий кусок.
+    std::byte *current_ = nullptr; //!< Начало свободного места в текущем куске.
+    std::byte *end_ = nullptr; //!< Конец текущего куска.
+    size_t initial_chunk_bytes_; //!< Размер первого куска, к нему арена возвращается после Release.
+    size_t next_chunk_bytes_; //!< Размер следующего куска.
+    size_t reserved_bytes_ = 0U; //!< Размер всех кусков.
+
+    /**
+     * @brief Выделяет новый кусок, в котором поместится блок указанного размера.
+     * @param bytes Размер блока.
+     * @param alignment Выравнивание блока.
+     */
+    void AddChunk(size_t bytes, size_t alignment);
+};
+
+/**
+ * @brief Аллокатор, выделяющий память из MonotonicArena.
+ * @details deallocate ничего не делает. Поддерживает расширение на месте (expand), которое
+ * RawMemory::TryExpand и Vector используют при росте. Аллокаторы равны, если ссылаются
+ * на одну арену.
+ * @tparam T Тип объекта, который будет размещаться в памяти.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T; //!< Тип объекта.
+
+    /**
+     * @brief Конструирует аллокатор для арены.
+     * @param arena Арена, которая должна пережить все выделенные из неё блоки.
+     */
+    explicit ArenaAllocator(MonotonicArena &arena) noexcept;
+
+    //! Конструктор преобразования из аллокатора для другого типа.
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept;  // NOLINT
+
+    /**
+     * @brief Выделяет сырую память под указанное количество элементов.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     */
+    T *allocate(size_t n);
+
+    /**
+     * @brief Ничего не делает: память возвращается только вместе со всей ареной.
+     */
+    void deallocate(T *p, size_t n) noexcept;
+
+    /**
+     * @brief Пытается расширить последний выделенный блок на месте.
+     * @param p Указатель на блок.
+     * @param old_n Текущее количество элементов.
+     * @param new_n Новое количество элементов.
+     * @return true, если блок расширен.
+     */
+    bool expand(T *p, size_t old_n, size_t new_n) noexcept;
+
+    /**
+     * @brief Получает арену.
+     * @return арену.
+     */
+    [[nodiscard]] MonotonicArena &GetArena() const noexcept;
+
+    //! Аллокаторы равны, если ссылаются на одну арену.
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const noexcept {
+        return arena_ == &other.GetArena();
+    }
+
+private:
+    MonotonicArena *arena_; //!< Арена.
+};
+
+inline MonotonicArena::MonotonicArena(const size_t initial_chunk_bytes) noexcept
+: initial_chunk_bytes_(std::max(initial_chunk_bytes, sizeof(Chunk) * 2U))
+, next_chunk_bytes_(initial_chunk_bytes_) {
+}
+
+inline MonotonicArena::~MonotonicArena() {
+    Release();
+}
+
+inline void *MonotonicArena::Allocate(const size_t bytes, const size_t alignment) {
+    auto space = static_cast<size_t>(end_ - current_);
+    void *p = current_;
+    if (current_ == nullptr || std::align(alignment, bytes, p, space) == nullptr) {
+        AddChunk(bytes, alignment);
+        space = static_cast<size_t>(end_ - current_);
+        p = current_;
+        std::align(alignment, bytes, p, space);
+    }
+    current_ = static_cast<std::byte *>(p) + bytes;
+    return p;
+}
+
+inline bool MonotonicArena::Expand(void *const p, const size_t old_bytes, const size_t new_bytes) noexcept {
+    auto *const begin = static_cast<std::byte *>(p);
+    if (begin + old_bytes != current_ || new_bytes < old_bytes
+        || new_bytes - old_bytes > static_cast<size_t>(end_ - current_)) {
+        return false;
+    }
+    current_ = begin + new_bytes;
+    return true;
+}
+
+inline void MonotonicArena::Release() noexcept {
+    while (chunk_ != nullptr) {
+        Chunk *const prev = chunk_->prev;
+        operator delete(chunk_, chunk_->bytes);
+        chunk_ = prev;
+    }
+    current_ = nullptr;
+    end_ = nullptr;
+    next_chunk_bytes_ = initial_chunk_bytes_;
+    reserved_bytes_ = 0U;
+}
+
+inline size_t MonotonicArena::ReservedBytes() const noexcept {
+    return reserved_bytes_;
+}
+
+inline void MonotonicArena::AddChunk(const size_t bytes, const size_t alignment) {
+    const size_t chunk_bytes = std::max(next_chunk_bytes_, sizeof(Chunk) + bytes + alignment);
+    auto *const chunk = static_cast<Chunk *>(operator new(chunk_bytes));
+    chunk->prev = chunk_;
+    chunk->bytes = chunk_bytes;
+    chunk_ = chunk;
+    current_ = reinterpret_cast<std::byte *>(chunk) + sizeof(Chunk);
+    end_ = reinterpret_cast<std::byte *>(chunk) + chunk_bytes;
+    reserved_bytes_ += chunk_bytes;
+    next_chunk_bytes_ = chunk_bytes * 2U;
+}
+
+template <typename T>
+ArenaAllocator<T>::ArenaAllocator(MonotonicArena &arena) noexcept
+: arena_(&arena) {
+}
+
+template <typename T>
+template <typename U>
+ArenaAllocator<T>::ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+: arena_(&other.GetArena()) {
+}
+
+template <typename T>
+T *ArenaAllocator<T>::allocate(const size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    return static_cast<T *>(arena_->Allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void ArenaAllocator<T>::deallocate(T * /*p*/, size_t /*n*/) noexcept {
+}
+
+template <typename T>
+bool ArenaAllocator<T>::expand(T *const p, const size_t old_n, const size_t new_n) noexcept {
+    if (new_n > static_cast<size_t>(-1) / sizeof(T)) {
+        return false;
+    }
+    return arena_->Expand(p, old_n * sizeof(T), new_n * sizeof(T));
+}
+
+template <typename T>
+MonotonicArena &ArenaAllocator<T>::GetArena() const noexcept {
+    return *arena_;
+}
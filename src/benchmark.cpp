@@ -0,0 +1,591 @@
+#include "benchmark.h"
+#include "concurrent_vector.h"
+#include "huge_page_allocator.h"
+#include "incremental_vector.h"
+#include "malloc_allocator.h"
+#include "pinned_vector.h"
+#include "segmented_vector.h"
+#include "soa_vector.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Строка длиннее буфера SSO, чтобы копирование действительно выделяло память
+const std::string PAYLOAD(32, 'x');
+
+// Элемент, перемещение которого может бросить исключение: при росте его придётся копировать
+struct ThrowingMove {
+    ThrowingMove() = default;
+    explicit ThrowingMove(std::string value)
+        : value(std::move(value))
+    {
+    }
+    ThrowingMove(const ThrowingMove& other) = default;
+    ThrowingMove(ThrowingMove&& other) noexcept(false)
+        : value(std::move(other.value))
+    {
+    }
+    ThrowingMove& operator=(const ThrowingMove& other) = default;
+    ThrowingMove& operator=(ThrowingMove&& other) noexcept(false) {
+        value = std::move(other.value);
+        return *this;
+    }
+
+    std::string value;
+};
+
+template <typename T>
+T MakeValue(size_t i);
+
+template <>
+int64_t MakeValue<int64_t>(size_t i) {
+    return static_cast<int64_t>(i);
+}
+
+template <>
+std::string MakeValue<std::string>(size_t /*i*/) {
+    return PAYLOAD;
+}
+
+template <>
+ThrowingMove MakeValue<ThrowingMove>(size_t /*i*/) {
+    return ThrowingMove{PAYLOAD};
+}
+
+size_t Weight(int64_t value) {
+    return static_cast<size_t>(value);
+}
+
+size_t Weight(const std::string& value) {
+    return value.size();
+}
+
+size_t Weight(const ThrowingMove& value) {
+    return value.value.size();
+}
+
+// Единый интерфейс к Vector и std::vector, чтобы сценарии были общими
+template <typename T>
+void Append(Vector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void Append(std::vector<T>& v, const T& value) {
+    v.push_back(value);
+}
+
+template <typename T>
+void InsertAt(Vector<T>& v, size_t index, const T& value) {
+    v.Insert(v.cbegin() + index, value);
+}
+
+template <typename T>
+void InsertAt(std::vector<T>& v, size_t index, const T& value) {
+    v.insert(v.cbegin() + static_cast<std::ptrdiff_t>(index), value);
+}
+
+template <typename T>
+void EraseAt(Vector<T>& v, size_t index) {
+    v.Erase(v.cbegin() + index);
+}
+
+template <typename T>
+void EraseAt(std::vector<T>& v, size_t index) {
+    v.erase(v.cbegin() + static_cast<std::ptrdiff_t>(index));
+}
+
+template <typename T>
+void PopBack(Vector<T>& v) {
+    v.PopBack();
+}
+
+template <typename T>
+void PopBack(std::vector<T>& v) {
+    v.pop_back();
+}
+
+template <typename T>
+void ReserveTo(Vector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void ReserveTo(std::vector<T>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+
+template <typename T>
+void ResizeTo(Vector<T>& v, size_t size) {
+    v.Resize(size);
+}
+
+template <typename T>
+void ResizeTo(std::vector<T>& v, size_t size) {
+    v.resize(size);
+}
+
+template <typename Container>
+Container Filled(size_t size) {
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+    Container v;
+    ReserveTo(v, size);
+    for (size_t i = 0; i < size; ++i) {
+        Append(v, MakeValue<T>(i));
+    }
+    return v;
+}
+
+template <typename Container, typename T>
+void BenchmarkContainer(BenchmarkRunner& runner, const std::string& prefix) {
+    const T value = MakeValue<T>(1);
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        runner.Run(prefix + "/EmplaceBack", size,
+            [] {
+                return Container{};
+            },
+            [&value, size](Container& v) {
+                for (size_t i = 0; i < size; ++i) {
+                    Append(v, value);
+                }
+            });
+        runner.Run(prefix + "/Insert", size,
+            [size] {
+                Container v = Filled<Container>(size);
+                ReserveTo(v, size + 1U);
+                return v;
+            },
+            [&value, size](Container& v) {
+                InsertAt(v, size / 2U, value);
+                PopBack(v);
+            });
+        runner.Run(prefix + "/Erase", size,
+            [size] {
+                return Filled<Container>(size);
+            },
+            [&value, size](Container& v) {
+                EraseAt(v, size / 2U);
+                Append(v, value);
+            });
+        runner.Run(prefix + "/Reserve", size,
+            [size] {
+                return Filled<Container>(size);
+            },
+            [size](Container& v) {
+                ReserveTo(v, size * 2U);
+            });
+        runner.Run(prefix + "/Resize", size,
+            [] {
+                return Container{};
+            },
+            [size](Container& v) {
+                ResizeTo(v, size);
+            });
+
+        const Container source = Filled<Container>(size);
+        runner.Run(prefix + "/CopyAssign", size,
+            [] {
+                return Container{};
+            },
+            [&source](Container& v) {
+                v = source;
+            });
+        runner.Run(prefix + "/MoveAssign", size,
+            [&source] {
+                return std::make_pair(source, Container{});
+            },
+            [](std::pair<Container, Container>& state) {
+                state.second = std::move(state.first);
+            });
+        runner.Run(prefix + "/Iterate", size,
+            [] {
+                return 0;
+            },
+            [&source](int& /*state*/) {
+                size_t sum = 0;
+                for (const auto& item : source) {
+                    sum += Weight(item);
+                }
+                DoNotOptimize(sum);
+            });
+    }
+}
+
+// Удаление каждого второго элемента: по одному, одним проходом и по списку индексов
+template <typename T>
+void BenchmarkBatchErase(BenchmarkRunner& runner, const std::string& element) {
+    // Удаление по одному квадратично, на больших размерах оно занимает минуты
+    const size_t MAX_LOOP_SIZE = 10'000;
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        if (size <= MAX_LOOP_SIZE) {
+            runner.Run("Vector<" + element + ">/EraseLoop", size,
+                [size] {
+                    return Filled<Vector<T>>(size);
+                },
+                [](Vector<T>& v) {
+                    for (size_t i = 0; i < v.Size(); ++i) {
+                        v.Erase(v.cbegin() + i);
+                    }
+                });
+        }
+        runner.Run("Vector<" + element + ">/EraseIf", size,
+            [size] {
+                return Filled<Vector<T>>(size);
+            },
+            [](Vector<T>& v) {
+                size_t i = 0;
+                v.EraseIf([&i](const T& /*item*/) {
+                    return (i++ % 2U) == 0U;
+                });
+            });
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < size; i += 2U) {
+            indices.push_back(i);
+        }
+        runner.Run("Vector<" + element + ">/EraseIndices", size,
+            [size] {
+                return Filled<Vector<T>>(size);
+            },
+            [&indices](Vector<T>& v) {
+                v.EraseIndices(indices);
+            });
+        runner.Run("std::vector<" + element + ">/erase_if", size,
+            [size] {
+                return Filled<std::vector<T>>(size);
+            },
+            [](std::vector<T>& v) {
+                size_t i = 0;
+                std::erase_if(v, [&i](const T& /*item*/) {
+                    return (i++ % 2U) == 0U;
+                });
+            });
+    }
+}
+
+// Буфер под перезапись: Resize обнуляет элементы, ResizeDefaultInit оставляет как есть
+void BenchmarkResizeDefaultInit(BenchmarkRunner& runner) {
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        runner.Run("Vector<trivial>/ResizeDefaultInit", size,
+            [] {
+                return Vector<int64_t>{};
+            },
+            [size](Vector<int64_t>& v) {
+                v.ResizeDefaultInit(size);
+            });
+    }
+}
+
+// Создание заполненного нулями вектора: memset против calloc/mmap
+template <typename Allocator>
+void BenchmarkZeroFilled(BenchmarkRunner& runner, const std::string& name) {
+    using Container = Vector<int64_t, Allocator>;
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        runner.Run("ZeroFilled/" + name, size,
+            [] {
+                return std::unique_ptr<Container>{};
+            },
+            [size](std::unique_ptr<Container>& v) {
+                v = std::make_unique<Container>(size);
+                DoNotOptimize(v->begin());
+            });
+    }
+}
+
+// Запись, из которой сканируется одно поле
+struct Particle {
+    double x;
+    double y;
+    double z;
+    double mass;
+    int64_t id;
+};
+
+// Сумма одного поля: массив записей против столбца SoAVector
+void BenchmarkSoAScan(BenchmarkRunner& runner) {
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        Vector<Particle> records;
+        SoAVector<double, double, double, double, int64_t> columns;
+        records.Reserve(size);
+        columns.Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            const auto value = static_cast<double>(i);
+            records.PushBack(Particle{value, value, value, value, static_cast<int64_t>(i)});
+            columns.EmplaceBack(value, value, value, value, static_cast<int64_t>(i));
+        }
+        runner.Run("FieldScan/Vector<struct>", size,
+            [] {
+                return 0;
+            },
+            [&records](int& /*state*/) {
+                double sum = 0.0;
+                for (const Particle& particle : records) {
+                    sum += particle.mass;
+                }
+                DoNotOptimize(sum);
+            });
+        runner.Run("FieldScan/SoAVector", size,
+            [] {
+                return 0;
+            },
+            [&columns](int& /*state*/) {
+                double sum = 0.0;
+                for (const double mass : std::as_const(columns).Column<3>()) {
+                    sum += mass;
+                }
+                DoNotOptimize(sum);
+            });
+    }
+}
+
+// Добавление из нескольких потоков: Vector под мьютексом против ConcurrentVector
+void BenchmarkConcurrentAppend(BenchmarkRunner& runner) {
+    const size_t num_threads = std::max(2U, std::thread::hardware_concurrency());
+    const auto run_threads = [num_threads](const auto& body) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < num_threads; ++t) {
+            threads.emplace_back(body);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    };
+    const std::string suffix = "/" + std::to_string(num_threads) + "threads";
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        const size_t per_thread = std::max<size_t>(size / num_threads, 1U);
+        runner.Run("ConcurrentAppend/MutexVector" + suffix, size,
+            [] {
+                return std::make_unique<std::pair<std::mutex, Vector<int64_t>>>();
+            },
+            [&run_threads, per_thread](std::unique_ptr<std::pair<std::mutex, Vector<int64_t>>>& state) {
+                run_threads([&state, per_thread] {
+                    for (size_t i = 0; i < per_thread; ++i) {
+                        const std::lock_guard lock(state->first);
+                        state->second.PushBack(static_cast<int64_t>(i));
+                    }
+                });
+            });
+        runner.Run("ConcurrentAppend/ConcurrentVector" + suffix, size,
+            [] {
+                return std::make_unique<ConcurrentVector<int64_t>>();
+            },
+            [&run_threads, per_thread](std::unique_ptr<ConcurrentVector<int64_t>>& v) {
+                run_threads([&v, per_thread] {
+                    for (size_t i = 0; i < per_thread; ++i) {
+                        v->PushBack(static_cast<int64_t>(i));
+                    }
+                });
+            });
+    }
+}
+
+// Добавление без Reserve и последующий обход по индексу: Vector против векторов без переноса элементов
+template <typename Container>
+void BenchmarkAppendAndIndex(BenchmarkRunner& runner, const std::string& name) {
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        runner.Run("AppendAndIndex/" + name, size,
+            [] {
+                return Container();
+            },
+            [size](Container& v) {
+                for (size_t i = 0; i < size; ++i) {
+                    v.PushBack(static_cast<int64_t>(i));
+                }
+                int64_t sum = 0;
+                for (size_t i = 0; i < size; ++i) {
+                    sum += v[i];
+                }
+                DoNotOptimize(sum);
+            });
+    }
+}
+
+// Задержка одного PushBack: Vector переносит всё при росте, IncrementalVector - по частям
+template <typename Container>
+void BenchmarkAppendLatency(BenchmarkRunner& runner, const std::string& name) {
+    using Clock = std::chrono::steady_clock;
+    for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+        BenchmarkResult* result = runner.Run("AppendLatency/" + name, size,
+            [] {
+                return Container();
+            },
+            [size](Container& v) {
+                for (size_t i = 0; i < size; ++i) {
+                    v.PushBack(static_cast<int64_t>(i));
+                }
+            });
+        if (result == nullptr) {
+            continue;
+        }
+        // Гистограмма задержек снимается на одном отдельном векторе
+        std::vector<int64_t> latencies_ns(size);
+        Container v;
+        for (size_t i = 0; i < size; ++i) {
+            const auto start = Clock::now();
+            v.PushBack(static_cast<int64_t>(i));
+            latencies_ns[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        }
+        DoNotOptimize(v[size - 1U]);
+        std::sort(latencies_ns.begin(), latencies_ns.end());
+        const auto percentile = [&latencies_ns](double fraction) {
+            const auto rank = static_cast<size_t>(fraction * static_cast<double>(latencies_ns.size() - 1U));
+            return static_cast<double>(latencies_ns[rank]);
+        };
+        result->counters["p50_ns"] = percentile(0.5);
+        result->counters["p99_ns"] = percentile(0.99);
+        result->counters["p99.9_ns"] = percentile(0.999);
+        result->counters["p99.99_ns"] = percentile(0.9999);
+        result->counters["max_latency_ns"] = static_cast<double>(latencies_ns.back());
+    }
+}
+
+template <typename T>
+void BenchmarkElement(BenchmarkRunner& runner, const std::string& element) {
+    BenchmarkContainer<Vector<T>, T>(runner, "Vector<" + element + ">");
+    BenchmarkContainer<std::vector<T>, T>(runner, "std::vector<" + element + ">");
+}
+
+// Аллокатор, отслеживающий текущий и пиковый объём занятой памяти
+template <typename T>
+struct PeakAllocator {
+    using value_type = T;
+
+    PeakAllocator() noexcept = default;
+
+    template <typename U>
+    PeakAllocator(const PeakAllocator<U>& /*other*/) noexcept {  // NOLINT
+    }
+
+    T* allocate(size_t n) {
+        live_bytes += n * sizeof(T);
+        peak_bytes = std::max(peak_bytes, live_bytes);
+        return static_cast<T*>(operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        live_bytes -= n * sizeof(T);
+        operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PeakAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+
+    static void Reset() {
+        live_bytes = 0;
+        peak_bytes = 0;
+    }
+
+    static inline size_t live_bytes = 0;
+    static inline size_t peak_bytes = 0;
+};
+
+template <typename GrowthPolicy>
+void BenchmarkGrowthPolicy(BenchmarkRunner& runner, const std::string& name, size_t size) {
+    using Container = Vector<int, PeakAllocator<int>, GrowthPolicy>;
+    BenchmarkResult* result = runner.Run("GrowthPolicy/" + name, size,
+        [] {
+            return Container{};
+        },
+        [size](Container& v) {
+            for (size_t i = 0; i < size; ++i) {
+                v.PushBack(static_cast<int>(i));
+            }
+        });
+    if (result == nullptr) {
+        return;
+    }
+    // В замере живёт сразу много векторов, поэтому пик памяти меряется на одном отдельно
+    PeakAllocator<int>::Reset();
+    Container v;
+    for (size_t i = 0; i < size; ++i) {
+        v.PushBack(static_cast<int>(i));
+    }
+    result->counters["capacity"] = static_cast<double>(v.Capacity());
+    result->counters["peak_KiB"] = static_cast<double>(PeakAllocator<int>::peak_bytes) / 1024.0;
+}
+
+template <typename Allocator>
+void BenchmarkRandomAccess(BenchmarkRunner& runner, const std::string& name, size_t size) {
+    const size_t NUM_READS = 1'000'000;
+    if (size > runner.Options().max_size) {
+        return;
+    }
+    Vector<uint64_t, Allocator> v(size);
+    for (size_t i = 0; i < size; ++i) {
+        v[i] = i;
+    }
+    runner.Run("RandomAccess/" + name, size,
+        [] {
+            return uint64_t{1};
+        },
+        [&v, size](uint64_t& state) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < NUM_READS; ++i) {
+                // Линейный конгруэнтный генератор, чтобы обращения не предсказывались
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                sum += v[(state >> 16U) % size];
+            }
+            DoNotOptimize(sum);
+        });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchmarkRunner runner(BenchmarkOptions::Parse(argc, argv));
+        if (runner.Options().perf_counters && !runner.PerfCountersAvailable()) {
+            std::cerr << "Performance counters are unavailable, reporting wall time only" << std::endl;
+        }
+
+        BenchmarkElement<int64_t>(runner, "trivial");
+        BenchmarkElement<std::string>(runner, "nothrow_move");
+        BenchmarkElement<ThrowingMove>(runner, "throwing_move");
+
+        BenchmarkResizeDefaultInit(runner);
+        BenchmarkZeroFilled<std::allocator<int64_t>>(runner, "std::allocator");
+        BenchmarkZeroFilled<MallocAllocator<int64_t>>(runner, "MallocAllocator");
+
+        BenchmarkBatchErase<int64_t>(runner, "trivial");
+        BenchmarkBatchErase<std::string>(runner, "nothrow_move");
+
+        BenchmarkSoAScan(runner);
+        BenchmarkConcurrentAppend(runner);
+        BenchmarkAppendAndIndex<Vector<int64_t>>(runner, "Vector");
+        BenchmarkAppendAndIndex<SegmentedVector<int64_t>>(runner, "SegmentedVector");
+        BenchmarkAppendAndIndex<PinnedVector<int64_t>>(runner, "PinnedVector");
+        BenchmarkAppendLatency<Vector<int64_t>>(runner, "Vector");
+        BenchmarkAppendLatency<IncrementalVector<int64_t>>(runner, "IncrementalVector");
+
+        for (const size_t size : DecadeSizes(runner.Options().max_size)) {
+            BenchmarkGrowthPolicy<DoublingGrowth>(runner, "Doubling", size);
+            BenchmarkGrowthPolicy<OneAndHalfGrowth>(runner, "OneAndHalf", size);
+            BenchmarkGrowthPolicy<SizeClassGrowth>(runner, "SizeClass", size);
+            BenchmarkGrowthPolicy<FixedIncrementGrowth<(1U << 20U), (1U << 20U)>>(
+                runner, "FixedIncrement<1M,1M>", size);
+        }
+
+        const size_t random_access_size = std::min<size_t>(runner.Options().max_size, size_t{1} << 25U);
+        BenchmarkRandomAccess<std::allocator<uint64_t>>(runner, "std::allocator", random_access_size);
+        BenchmarkRandomAccess<HugePageAllocator<uint64_t>>(runner, "HugePageAllocator", random_access_size);
+
+        runner.Report(std::cout);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
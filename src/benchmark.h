@@ -0,0 +1,434 @@
+#pragma once
+
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Запрещает компилятору выбросить вычисление значения.
+ * @tparam T Тип значения.
+ * @param value Значение.
+ */
+template <typename T>
+void DoNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief Формат отчёта.
+ */
+enum class ReportFormat {
+    TEXT, //!< Таблица для человека.
+    JSON, //!< Массив объектов JSON.
+    CSV, //!< Значения, разделённые запятыми.
+};
+
+/**
+ * @brief Параметры запуска бенчмарков.
+ */
+struct BenchmarkOptions {
+    int warmup = 1; //!< Количество прогревочных замеров.
+    int repetitions = 5; //!< Количество замеров.
+    size_t max_size = 1'000'000U; //!< Наибольший размер контейнера.
+    std::chrono::nanoseconds min_sample_time = std::chrono::milliseconds(1); //!< Наименьшая длительность замера.
+    ReportFormat format = ReportFormat::TEXT; //!< Формат отчёта.
+    std::string filter; //!< Подстрока, которую должно содержать имя бенчмарка.
+    bool perf_counters = true; //!< Снимать ли счётчики производительности.
+
+    /**
+     * @brief Разбирает параметры командной строки.
+     * @details Поддерживаются --warmup=N, --repetitions=N, --max-size=N, --min-time-ms=N,
+     * --format=text|json|csv, --filter=SUBSTRING и --perf-counters=0|1.
+     * @param argc Количество аргументов.
+     * @param argv Аргументы.
+     * @return параметры.
+     * @throw std::invalid_argument при неизвестном или некорректном параметре.
+     */
+    static BenchmarkOptions Parse(int argc, const char *const argv[]);
+};
+
+/**
+ * @brief Результат одного бенчмарка.
+ */
+struct BenchmarkResult {
+    std::string name; //!< Имя бенчмарка.
+    size_t size = 0U; //!< Размер контейнера.
+    size_t iterations = 0U; //!< Количество вызовов тела в одном замере.
+    std::vector<double> samples_ns; //!< Время одного вызова тела в каждом замере.
+    //! Дополнительные показатели, в том числе счётчики производительности на один вызов тела.
+    std::map<std::string, double> counters;
+
+    //! Наименьшее время вызова.
+    [[nodiscard]] double MinNs() const;
+    //! Медианное время вызова.
+    [[nodiscard]] double MedianNs() const;
+    //! Среднее время вызова.
+    [[nodiscard]] double MeanNs() const;
+    //! Стандартное отклонение времени вызова.
+    [[nodiscard]] double StdDevNs() const;
+    //! Наибольшее время вызова.
+    [[nodiscard]] double MaxNs() const;
+};
+
+/**
+ * @brief Запускает бенчмарки и собирает результаты.
+ * @details Каждый бенчмарк - это пара функций: setup создаёт состояние, body выполняет
+ * измеряемую операцию над ним. Создание и уничтожение состояний не измеряется. Число вызовов
+ * body в замере подбирается так, чтобы замер длился не меньше min_sample_time, затем
+ * выполняются прогревочные и основные замеры. Во время основных замеров снимаются счётчики
+ * PerfCounters, если они доступны, и их значения на один вызов body попадают в counters.
+ */
+class BenchmarkRunner {
+public:
+    /**
+     * @brief Конструирует объект с указанными параметрами.
+     * @param options Параметры.
+     */
+    explicit BenchmarkRunner(BenchmarkOptions options);
+
+    /**
+     * @brief Запускает бенчмарк, если он проходит фильтр и ограничение размера.
+     * @tparam Setup Тип функции, создающей состояние.
+     * @tparam Body Тип измеряемой функции, принимающей состояние по ссылке.
+     * @param name Имя бенчмарка.
+     * @param size Размер контейнера.
+     * @param setup Функция, создающая состояние.
+     * @param body Измеряемая функция.
+     * @return указатель на результат, действительный до следующего вызова Run, или nullptr,
+     * если бенчмарк пропущен.
+     */
+    template <typename Setup, typename Body>
+    BenchmarkResult *Run(std::string name, size_t size, Setup setup, Body body);
+
+    /**
+     * @brief Получает параметры.
+     * @return параметры.
+     */
+    [[nodiscard]] const BenchmarkOptions &Options() const noexcept;
+
+    /**
+     * @brief Проверяет, снимаются ли счётчики производительности.
+     * @return true, если счётчики включены в параметрах и хотя бы один из них доступен.
+     */
+    [[nodiscard]] bool PerfCountersAvailable() const noexcept;
+
+    /**
+     * @brief Выводит отчёт обо всех результатах.
+     * @param out Поток вывода.
+     */
+    void Report(std::ostream &out) const;
+
+private:
+    using Clock = std::chrono::steady_clock; //!< Часы.
+
+    //! Наибольшее количество вызовов body в замере.
+    static constexpr size_t MAX_ITERATIONS = size_t{1} << 20U;
+    //! Наибольшее суммарное количество элементов во всех состояниях замера.
+    static constexpr size_t MAX_ITEMS_PER_SAMPLE = size_t{1} << 22U;
+
+    BenchmarkOptions options_; //!< Параметры.
+    std::vector<BenchmarkResult> results_; //!< Результаты.
+    std::unique_ptr<PerfCounters> perf_; //!< Счётчики, nullptr если отключены.
+
+    /**
+     * @brief Выполняет один замер.
+     * @param counters Куда прибавить значения счётчиков за замер, или nullptr.
+     * @return время всех вызовов body в замере.
+     */
+    template <typename Setup, typename Body>
+    Clock::duration Sample(size_t iterations, Setup &setup, Body &body,
+                           std::map<std::string, double> *counters = nullptr);
+
+    //! Отчёт в виде таблицы.
+    void ReportText(std::ostream &out) const;
+    //! Отчёт в формате JSON.
+    void ReportJson(std::ostream &out) const;
+    //! Отчёт в формате CSV.
+    void ReportCsv(std::ostream &out) const;
+
+    //! Имена всех дополнительных показателей.
+    [[nodiscard]] std::vector<std::string> CounterNames() const;
+};
+
+/**
+ * @brief Возвращает ряд размеров 1, 10, 100, ... не больше max_size.
+ * @param max_size Наибольший размер.
+ * @return размеры.
+ */
+inline std::vector<size_t> DecadeSizes(const size_t max_size) {
+    std::vector<size_t> sizes;
+    for (size_t size = 1U; size <= max_size; size *= 10U) {
+        sizes.push_back(size);
+        if (size > max_size / 10U) {
+            break;
+        }
+    }
+    return sizes;
+}
+
+inline BenchmarkOptions BenchmarkOptions::Parse(const int argc, const char *const argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const size_t eq = arg.find('=');
+        const std::string_view key = arg.substr(0, eq);
+        const std::string value((eq == std::string_view::npos) ? std::string_view{} : arg.substr(eq + 1U));
+        try {
+            if (key == "--warmup") {
+                options.warmup = std::stoi(value);
+            } else if (key == "--repetitions") {
+                options.repetitions = std::max(1, std::stoi(value));
+            } else if (key == "--max-size") {
+                options.max_size = std::stoull(value);
+            } else if (key == "--min-time-ms") {
+                options.min_sample_time = std::chrono::milliseconds(std::stoll(value));
+            } else if (key == "--filter") {
+                options.filter = value;
+            } else if (key == "--perf-counters") {
+                options.perf_counters = std::stoi(value) != 0;
+            } else if (key == "--format" && value == "text") {
+                options.format = ReportFormat::TEXT;
+            } else if (key == "--format" && value == "json") {
+                options.format = ReportFormat::JSON;
+            } else if (key == "--format" && value == "csv") {
+                options.format = ReportFormat::CSV;
+            } else {
+                throw std::invalid_argument("unknown option");
+            }
+        } catch (const std::logic_error &) {
+            throw std::invalid_argument("Bad benchmark option: " + std::string(arg));
+        }
+    }
+    return options;
+}
+
+inline double BenchmarkResult::MinNs() const {
+    return *std::min_element(samples_ns.begin(), samples_ns.end());
+}
+
+inline double BenchmarkResult::MaxNs() const {
+    return *std::max_element(samples_ns.begin(), samples_ns.end());
+}
+
+inline double BenchmarkResult::MedianNs() const {
+    std::vector<double> sorted = samples_ns;
+    std::sort(sorted.begin(), sorted.end());
+    const size_t mid = sorted.size() / 2U;
+    return (sorted.size() % 2U == 1U) ? sorted[mid] : (sorted[mid - 1U] + sorted[mid]) / 2.0;
+}
+
+inline double BenchmarkResult::MeanNs() const {
+    double sum = 0.0;
+    for (const double sample : samples_ns) {
+        sum += sample;
+    }
+    return sum / static_cast<double>(samples_ns.size());
+}
+
+inline double BenchmarkResult::StdDevNs() const {
+    if (samples_ns.size() < 2U) {
+        return 0.0;
+    }
+    const double mean = MeanNs();
+    double sum = 0.0;
+    for (const double sample : samples_ns) {
+        sum += (sample - mean) * (sample - mean);
+    }
+    return std::sqrt(sum / static_cast<double>(samples_ns.size() - 1U));
+}
+
+inline BenchmarkRunner::BenchmarkRunner(BenchmarkOptions options)
+: options_(std::move(options)) {
+    if (options_.perf_counters) {
+        perf_ = std::make_unique<PerfCounters>();
+    }
+}
+
+inline const BenchmarkOptions &BenchmarkRunner::Options() const noexcept {
+    return options_;
+}
+
+inline bool BenchmarkRunner::PerfCountersAvailable() const noexcept {
+    return perf_ != nullptr && perf_->Available();
+}
+
+template <typename Setup, typename Body>
+BenchmarkRunner::Clock::duration BenchmarkRunner::Sample(const size_t iterations, Setup &setup, Body &body,
+                                                         std::map<std::string, double> *const counters) {
+    std::vector<decltype(setup())> states;
+    states.reserve(iterations);
+    for (size_t i = 0; i < iterations; ++i) {
+        states.push_back(setup());
+    }
+    const bool measure_counters = counters != nullptr && PerfCountersAvailable();
+    if (measure_counters) {
+        perf_->Start();
+    }
+    const auto start = Clock::now();
+    for (auto &state : states) {
+        body(state);
+    }
+    const auto elapsed = Clock::now() - start;
+    if (measure_counters) {
+        perf_->Stop();
+        for (const auto &[counter, value] : perf_->Read()) {
+            (*counters)[counter] += value;
+        }
+    }
+    DoNotOptimize(states.data());
+    return elapsed;
+}
+
+template <typename Setup, typename Body>
+BenchmarkResult *BenchmarkRunner::Run(std::string name, const size_t size, Setup setup, Body body) {
+    if (size > options_.max_size || name.find(options_.filter) == std::string::npos) {
+        return nullptr;
+    }
+
+    // Состояния всех вызовов живут одновременно, поэтому их суммарный размер ограничен
+    const size_t max_iterations =
+        std::clamp<size_t>(MAX_ITEMS_PER_SAMPLE / std::max<size_t>(size, 1U), 1U, MAX_ITERATIONS);
+    size_t iterations = 1U;
+    while (iterations < max_iterations && Sample(iterations, setup, body) < options_.min_sample_time) {
+        iterations *= 2U;
+    }
+    for (int i = 0; i < options_.warmup; ++i) {
+        Sample(iterations, setup, body);
+    }
+
+    BenchmarkResult result;
+    result.name = std::move(name);
+    result.size = size;
+    result.iterations = iterations;
+    for (int i = 0; i < options_.repetitions; ++i) {
+        const auto elapsed = Sample(iterations, setup, body, &result.counters);
+        result.samples_ns.push_back(std::chrono::duration<double, std::nano>(elapsed).count()
+                                    / static_cast<double>(iterations));
+    }
+    const auto calls = static_cast<double>(iterations) * static_cast<double>(options_.repetitions);
+    for (auto &[counter, value] : result.counters) {
+        value /= calls;
+    }
+    const auto cycles = result.counters.find("cycles");
+    const auto instructions = result.counters.find("instructions");
+    if (cycles != result.counters.end() && instructions != result.counters.end() && cycles->second > 0.0) {
+        result.counters["ipc"] = instructions->second / cycles->second;
+    }
+    results_.push_back(std::move(result));
+    return &results_.back();
+}
+
+inline std::vector<std::string> BenchmarkRunner::CounterNames() const {
+    std::vector<std::string> names;
+    for (const BenchmarkResult &result : results_) {
+        for (const auto &[counter, value] : result.counters) {
+            if (std::find(names.begin(), names.end(), counter) == names.end()) {
+                names.push_back(counter);
+            }
+        }
+    }
+    return names;
+}
+
+inline void BenchmarkRunner::Report(std::ostream &out) const {
+    switch (options_.format) {
+    case ReportFormat::TEXT:
+        ReportText(out);
+        break;
+    case ReportFormat::JSON:
+        ReportJson(out);
+        break;
+    case ReportFormat::CSV:
+        ReportCsv(out);
+        break;
+    }
+}
+
+inline void BenchmarkRunner::ReportText(std::ostream &out) const {
+    const std::vector<std::string> counters = CounterNames();
+    out << std::left << std::setw(48) << "name" << std::right << std::setw(11) << "size"
+        << std::setw(14) << "median ns" << std::setw(14) << "min ns" << std::setw(10) << "stddev %"
+        << std::setw(14) << "ns/item";
+    for (const std::string &counter : counters) {
+        out << ' ' << std::setw(std::max<int>(12, static_cast<int>(counter.size()))) << counter;
+    }
+    out << '\n';
+    out << std::fixed << std::setprecision(1);
+    for (const BenchmarkResult &result : results_) {
+        const double median = result.MedianNs();
+        out << std::left << std::setw(48) << result.name << std::right << std::setw(11) << result.size
+            << std::setw(14) << median << std::setw(14) << result.MinNs()
+            << std::setw(10) << ((median > 0.0) ? 100.0 * result.StdDevNs() / result.MeanNs() : 0.0)
+            << std::setw(14) << median / static_cast<double>(std::max<size_t>(result.size, 1U));
+        for (const std::string &counter : counters) {
+            const auto it = result.counters.find(counter);
+            out << ' ' << std::setw(std::max<int>(12, static_cast<int>(counter.size())));
+            if (it != result.counters.end()) {
+                out << it->second;
+            } else {
+                out << '-';
+            }
+        }
+        out << '\n';
+    }
+    out << std::defaultfloat;
+}
+
+inline void BenchmarkRunner::ReportJson(std::ostream &out) const {
+    out << "[\n";
+    for (size_t i = 0; i < results_.size(); ++i) {
+        const BenchmarkResult &result = results_[i];
+        out << "  {\"name\": \"" << result.name << "\", \"size\": " << result.size
+            << ", \"iterations\": " << result.iterations
+            << ", \"repetitions\": " << result.samples_ns.size()
+            << ", \"min_ns\": " << result.MinNs() << ", \"median_ns\": " << result.MedianNs()
+            << ", \"mean_ns\": " << result.MeanNs() << ", \"stddev_ns\": " << result.StdDevNs()
+            << ", \"max_ns\": " << result.MaxNs() << ", \"counters\": {";
+        bool first = true;
+        for (const auto &[counter, value] : result.counters) {
+            out << (first ? "" : ", ") << '"' << counter << "\": " << value;
+            first = false;
+        }
+        out << "}}" << ((i + 1U == results_.size()) ? "\n" : ",\n");
+    }
+    out << "]\n";
+}
+
+inline void BenchmarkRunner::ReportCsv(std::ostream &out) const {
+    const std::vector<std::string> counters = CounterNames();
+    out << "name,size,iterations,repetitions,min_ns,median_ns,mean_ns,stddev_ns,max_ns";
+    for (const std::string &counter : counters) {
+        out << ',' << counter;
+    }
+    out << '\n';
+    for (const BenchmarkResult &result : results_) {
+        out << result.name << ',' << result.size << ',' << result.iterations << ','
+            << result.samples_ns.size() << ',' << result.MinNs() << ',' << result.MedianNs() << ','
+            << result.MeanNs() << ',' << result.StdDevNs() << ',' << result.MaxNs();
+        for (const std::string &counter : counters) {
+            const auto it = result.counters.find(counter);
+            out << ',';
+            if (it != result.counters.end()) {
+                out << it->second;
+            }
+        }
+        out << '\n';
+    }
+}
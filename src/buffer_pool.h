@@ -0,0 +1,293 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+/**
+ * @brief Статистика пула буферов.
+ */
+struct BufferPoolStats {
+    size_t hits = 0U; //!< Запросы, обслуженные из пула.
+    size_t misses = 0U; //!< Запросы, ушедшие в operator new.
+    size_t recycled = 0U; //!< Буферы, возвращённые в пул.
+    size_t released = 0U; //!< Буферы, отданные operator delete.
+
+    /**
+     * @brief Доля запросов, обслуженных из пула.
+     * @return число от 0 до 1.
+     */
+    [[nodiscard]] double HitRate() const noexcept {
+        const size_t requests = hits + misses;
+        return (requests == 0U) ? 0.0 : static_cast<double>(hits) / static_cast<double>(requests);
+    }
+};
+
+/**
+ * @brief Пул освобождённых буферов, разложенных по классам размеров - степеням двойки.
+ * @details Буфер запрошенного размера округляется вверх до степени двойки, и если в списке
+ * этого класса есть ранее возвращённый буфер, он выдаётся повторно без обращения к куче.
+ * Освобождённые буферы складываются обратно в свой класс, пока в нём не больше
+ * MaxCachedPerClass штук. Буферы больше MAX_POOLED_BYTES не кэшируются.
+ * Каждый поток работает со своим пулом, см. Local(), поэтому синхронизация не нужна.
+ * Пул потока уничтожается раньше статических объектов, поэтому LocalIfAlive() позволяет
+ * аллокатору обойтись без пула, если память освобождается уже после его уничтожения.
+ */
+class BufferPool {
+public:
+    static constexpr size_t MIN_CLASS_BYTES = 16U; //!< Наименьший класс размеров.
+    static constexpr size_t MAX_POOLED_BYTES = size_t{1} << 26U; //!< Наибольший класс размеров.
+    static constexpr size_t DEFAULT_MAX_CACHED_PER_CLASS = 16U; //!< Буферов в классе по умолчанию.
+
+    BufferPool() = default;
+
+    //! Запрет на копирование.
+    BufferPool(const BufferPool &) = delete;
+    //! Запрет на копирование.
+    BufferPool &operator=(const BufferPool &) = delete;
+
+    /**
+     * @brief Возвращает кэшированные буферы в кучу.
+     */
+    ~BufferPool();
+
+    /**
+     * @brief Получает пул текущего потока.
+     * @return пул.
+     */
+    static BufferPool &Local() noexcept;
+
+    /**
+     * @brief Получает пул текущего потока, если он ещё не уничтожен.
+     * @return пул или nullptr, если поток уже уничтожил свои thread_local объекты.
+     */
+    static BufferPool *LocalIfAlive() noexcept;
+
+    /**
+     * @brief Выдаёт буфер не меньше указанного размера.
+     * @param bytes Размер в байтах.
+     * @return указатель на буфер.
+     */
+    void *Allocate(size_t bytes);
+
+    /**
+     * @brief Возвращает буфер, полученный через Allocate с тем же размером.
+     * @param p Указатель на буфер.
+     * @param bytes Размер, с которым запрашивался буфер.
+     */
+    void Deallocate(void *p, size_t bytes) noexcept;
+
+    /**
+     * @brief Возвращает все кэшированные буферы в кучу.
+     */
+    void Trim() noexcept;
+
+    /**
+     * @brief Задаёт максимальное количество кэшируемых буферов в каждом классе.
+     * @param max_cached Количество буферов.
+     */
+    void SetMaxCachedPerClass(size_t max_cached) noexcept;
+
+    /**
+     * @brief Получает статистику.
+     * @return статистику с момента создания пула или последнего ResetStats.
+     */
+    [[nodiscard]] const BufferPoolStats &Stats() const noexcept;
+
+    /**
+     * @brief Обнуляет статистику.
+     */
+    void ResetStats() noexcept;
+
+private:
+    //! Количество классов размеров.
+    static constexpr size_t NUM_CLASSES = std::bit_width(MAX_POOLED_BYTES / MIN_CLASS_BYTES);
+
+    /**
+     * @brief Свободный буфер, хранящий в себе ссылку на следующий.
+     */
+    struct FreeBlock {
+        FreeBlock *next = nullptr; //!< Следующий свободный буфер класса.
+    };
+
+    /**
+     * @brief Список свободных буферов одного класса.
+     */
+    struct SizeClass {
+        FreeBlock *head = nullptr; //!< Первый свободный буфер.
+        size_t count = 0U; //!< Количество свободных буферов.
+    };
+
+    std::array<SizeClass, NUM_CLASSES> classes_{}; //!< Классы размеров.
+    size_t max_cached_per_class_ = DEFAULT_MAX_CACHED_PER_CLASS; //!< Буферов в классе.
+    BufferPoolStats stats_; //!< Статистика.
+
+    //! Пул текущего потока уже уничтожен.
+    static inline thread_local bool local_destroyed_ = false;
+
+    /**
+     * @brief Вычисляет класс размеров.
+     * @param bytes Размер в байтах, не больше MAX_POOLED_BYTES.
+     * @return индекс класса.
+     */
+    static size_t ClassIndex(size_t bytes) noexcept;
+
+    /**
+     * @brief Вычисляет размер буфера класса.
+     * @param index Индекс класса.
+     * @return размер в байтах.
+     */
+    static size_t ClassBytes(size_t index) noexcept;
+};
+
+/**
+ * @brief Аллокатор, переиспользующий буферы из BufferPool текущего потока.
+ * @details Подходит для векторов, которые постоянно создаются, дорастают до похожих
+ * размеров и уничтожаются: после прогрева память берётся из пула, а не из кучи.
+ * @tparam T Тип объекта, который будет размещаться в памяти.
+ */
+template <typename T>
+class PooledAllocator {
+public:
+    using value_type = T; //!< Тип объекта.
+    using is_always_equal = std::true_type; //!< Аллокатор не имеет состояния.
+
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "PooledAllocator does not support over-aligned types");
+
+    PooledAllocator() noexcept = default;
+
+    //! Конструктор преобразования из аллокатора для другого типа.
+    template <typename U>
+    PooledAllocator(const PooledAllocator<U> & /*other*/) noexcept {  // NOLINT
+    }
+
+    /**
+     * @brief Выделяет сырую память под указанное количество элементов.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     */
+    T *allocate(size_t n);
+
+    /**
+     * @brief Возвращает память в пул текущего потока.
+     * @param p Указатель на память.
+     * @param n Количество элементов, под которое выделялась память.
+     */
+    void deallocate(T *p, size_t n) noexcept;
+
+    //! Все экземпляры взаимозаменяемы.
+    template <typename U>
+    bool operator==(const PooledAllocator<U> & /*other*/) const noexcept {
+        return true;
+    }
+};
+
+inline BufferPool::~BufferPool() {
+    Trim();
+}
+
+inline BufferPool &BufferPool::Local() noexcept {
+    struct LocalPool : BufferPool {
+        ~LocalPool() {
+            local_destroyed_ = true;
+        }
+    };
+    thread_local LocalPool pool;
+    return pool;
+}
+
+inline BufferPool *BufferPool::LocalIfAlive() noexcept {
+    return local_destroyed_ ? nullptr : &Local();
+}
+
+inline size_t BufferPool::ClassIndex(const size_t bytes) noexcept {
+    return (bytes <= MIN_CLASS_BYTES) ? 0U : std::bit_width((bytes - 1U) / MIN_CLASS_BYTES);
+}
+
+inline size_t BufferPool::ClassBytes(const size_t index) noexcept {
+    return MIN_CLASS_BYTES << index;
+}
+
+inline void *BufferPool::Allocate(const size_t bytes) {
+    if (bytes > MAX_POOLED_BYTES) {
+        ++stats_.misses;
+        return operator new(bytes);
+    }
+    SizeClass &size_class = classes_[ClassIndex(bytes)];
+    if (size_class.head != nullptr) {
+        FreeBlock *const block = size_class.head;
+        size_class.head = block->next;
+        --size_class.count;
+        ++stats_.hits;
+        return block;
+    }
+    ++stats_.misses;
+    return operator new(ClassBytes(ClassIndex(bytes)));
+}
+
+inline void BufferPool::Deallocate(void *const p, const size_t bytes) noexcept {
+    if (bytes > MAX_POOLED_BYTES) {
+        ++stats_.released;
+        operator delete(p, bytes);
+        return;
+    }
+    SizeClass &size_class = classes_[ClassIndex(bytes)];
+    if (size_class.count >= max_cached_per_class_) {
+        ++stats_.released;
+        operator delete(p, ClassBytes(ClassIndex(bytes)));
+        return;
+    }
+    size_class.head = new (p) FreeBlock{size_class.head};
+    ++size_class.count;
+    ++stats_.recycled;
+}
+
+inline void BufferPool::Trim() noexcept {
+    for (size_t index = 0; index < NUM_CLASSES; ++index) {
+        SizeClass &size_class = classes_[index];
+        while (size_class.head != nullptr) {
+            FreeBlock *const next = size_class.head->next;
+            operator delete(size_class.head, ClassBytes(index));
+            size_class.head = next;
+        }
+        size_class.count = 0U;
+    }
+}
+
+inline void BufferPool::SetMaxCachedPerClass(const size_t max_cached) noexcept {
+    max_cached_per_class_ = max_cached;
+}
+
+inline const BufferPoolStats &BufferPool::Stats() const noexcept {
+    return stats_;
+}
+
+inline void BufferPool::ResetStats() noexcept {
+    stats_ = BufferPoolStats{};
+}
+
+template <typename T>
+T *PooledAllocator<T>::allocate(const size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    BufferPool *const pool = BufferPool::LocalIfAlive();
+    if (pool == nullptr) {
+        return static_cast<T *>(operator new(n * sizeof(T)));
+    }
+    return static_cast<T *>(pool->Allocate(n * sizeof(T)));
+}
+
+template <typename T>
+void PooledAllocator<T>::deallocate(T *const p, const size_t n) noexcept {
+    BufferPool *const pool = BufferPool::LocalIfAlive();
+    if (pool == nullptr) {
+        // Размер мог быть округлён пулом до класса, поэтому размер не передаётся
+        operator delete(p);
+        return;
+    }
+    pool->Deallocate(p, n * sizeof(T));
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "vector.h"
+#include "vector_instrumentation.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <source_location>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+/**
+ * @brief Статистика роста векторов в одном месте вызова.
+ */
+struct CallSiteStats {
+    std::source_location site; //!< Место вызова.
+    size_t growths = 0U; //!< Количество увеличений вместимости.
+    size_t reallocations = 0U; //!< Сколько раз при этом элементы переносились в новый буфер.
+    size_t bytes_copied = 0U; //!< Сколько байт элементов перенесено.
+};
+
+/**
+ * @brief Собирает статистику роста векторов по местам вызова PushBack, EmplaceBack и Insert.
+ * @details Нужен, чтобы находить места, где не хватает Reserve. Статистика общая для всех
+ * потоков. При завершении программы непустой отчёт, отсортированный по количеству
+ * перенесённых байт, выводится в std::cerr, если это не отключено SetReportAtExit(false).
+ */
+class CallSiteProfiler {
+public:
+    //! Запрет на копирование.
+    CallSiteProfiler(const CallSiteProfiler &) = delete;
+    //! Запрет на копирование.
+    CallSiteProfiler &operator=(const CallSiteProfiler &) = delete;
+
+    /**
+     * @brief Выводит отчёт, если это не отключено.
+     */
+    ~CallSiteProfiler();
+
+    /**
+     * @brief Получает профилировщик программы.
+     * @return профилировщик.
+     */
+    static CallSiteProfiler &Instance() noexcept;
+
+    /**
+     * @brief Учитывает увеличение вместимости.
+     * @param event Событие роста с известным местом вызова.
+     */
+    void Record(const VectorEvent &event) noexcept;
+
+    /**
+     * @brief Получает статистику, отсортированную по убыванию перенесённых байт.
+     * @return статистику по местам вызова.
+     */
+    [[nodiscard]] std::vector<CallSiteStats> Sorted() const;
+
+    /**
+     * @brief Выводит отчёт.
+     * @param out Поток вывода.
+     * @param limit Наибольшее количество строк отчёта.
+     */
+    void Report(std::ostream &out, size_t limit = static_cast<size_t>(-1)) const;
+
+    /**
+     * @brief Включает или отключает вывод отчёта при завершении программы.
+     * @param enabled Выводить ли отчёт.
+     */
+    void SetReportAtExit(bool enabled) noexcept;
+
+    /**
+     * @brief Забывает всю статистику.
+     */
+    void Reset() noexcept;
+
+private:
+    //! Ключ места вызова: имя файла, строка и позиция в строке.
+    using Key = std::tuple<std::string_view, uint_least32_t, uint_least32_t>;
+
+    mutable std::mutex mutex_; //!< Защищает stats_.
+    std::map<Key, CallSiteStats> stats_; //!< Статистика по местам вызова.
+    bool report_at_exit_ = true; //!< Выводить ли отчёт при завершении.
+
+    CallSiteProfiler() = default;
+};
+
+/**
+ * @brief Инструментирование Vector, передающее рост при вставке в CallSiteProfiler.
+ * @details Учитываются только события с известным местом вызова: PushBack и Insert получают
+ * его аргументом по умолчанию, EmplaceBack и Emplace - через CallSite первым аргументом.
+ */
+struct CallSiteInstrumentation {
+    static constexpr bool ENABLED = true; //!< Инструментирование включено.
+
+    //! Передаёт событие роста профилировщику.
+    static void OnEvent(const VectorEvent &event) noexcept {
+        if (event.kind == VectorEventKind::GROW && event.site.line() != 0U) {
+            CallSiteProfiler::Instance().Record(event);
+        }
+    }
+};
+
+/**
+ * @brief Вектор, рост которого учитывается по местам вызова.
+ * @tparam T Тип элемента вектора.
+ * @tparam Allocator Тип аллокатора.
+ * @tparam GrowthPolicy Стратегия роста вместимости.
+ */
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+using ProfiledVector = Vector<T, Allocator, GrowthPolicy, CallSiteInstrumentation>;
+
+inline CallSiteProfiler::~CallSiteProfiler() {
+    if (report_at_exit_ && !stats_.empty()) {
+        std::cerr << "Vector growth by call site:\n";
+        Report(std::cerr);
+    }
+}
+
+inline CallSiteProfiler &CallSiteProfiler::Instance() noexcept {
+    // std::cerr должен пережить профилировщик, поэтому он инициализируется раньше
+    static const std::ios_base::Init IOSTREAM_INIT;
+    static CallSiteProfiler profiler;
+    return profiler;
+}
+
+inline void CallSiteProfiler::Record(const VectorEvent &event) noexcept {
+    const Key key{event.site.file_name(), event.site.line(), event.site.column()};
+    try {
+        const std::lock_guard lock(mutex_);
+        CallSiteStats &stats = stats_[key];
+        stats.site = event.site;
+        ++stats.growths;
+        if (event.bytes_moved != 0U) {
+            ++stats.reallocations;
+            stats.bytes_copied += event.bytes_moved;
+        }
+    } catch (...) {
+        // Профилирование не должно ломать программу, событие просто теряется
+    }
+}
+
+inline std::vector<CallSiteStats> CallSiteProfiler::Sorted() const {
+    std::vector<CallSiteStats> sorted;
+    {
+        const std::lock_guard lock(mutex_);
+        sorted.reserve(stats_.size());
+        for (const auto &[key, stats] : stats_) {
+            sorted.push_back(stats);
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const CallSiteStats &lhs, const CallSiteStats &rhs) {
+        return std::tie(lhs.bytes_copied, lhs.reallocations) > std::tie(rhs.bytes_copied, rhs.reallocations);
+    });
+    return sorted;
+}
+
+inline void CallSiteProfiler::Report(std::ostream &out, const size_t limit) const {
+    const std::vector<CallSiteStats> sorted = Sorted();
+    for (size_t i = 0; i < std::min(limit, sorted.size()); ++i) {
+        const CallSiteStats &stats = sorted[i];
+        out << stats.site.file_name() << ':' << stats.site.line() << ':' << stats.site.column() << ' '
+            << stats.site.function_name() << ": " << stats.growths << " growths, " << stats.reallocations
+            << " reallocations, " << stats.bytes_copied << " bytes copied\n";
+    }
+}
+
+inline void CallSiteProfiler::SetReportAtExit(const bool enabled) noexcept {
+    const std::lock_guard lock(mutex_);
+    report_at_exit_ = enabled;
+}
+
+inline void CallSiteProfiler::Reset() noexcept {
+    const std::lock_guard lock(mutex_);
+    stats_.clear();
+}
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "raw_memory.h"
+#include "segment_layout.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <utility>
+
+/**
+ * @brief Вектор только для добавления, в который можно одновременно добавлять из многих потоков.
+ * @details Элементы хранятся в сегментах RawMemory растущего вдвое размера: сегмент k
+ * вмещает FirstSegmentSize * 2^k элементов. EmplaceBack занимает индекс атомарным
+ * fetch_add и конструирует элемент в его ячейке, не беря блокировок. Сегмент выделяет
+ * поток, занявший его первый индекс, а остальные потоки этого сегмента ждут его публикации.
+ * Рост не перемещает существующие элементы, поэтому ссылки на них остаются действительными,
+ * а читатели могут обходить вектор через ForEach одновременно с добавлением: у каждой ячейки
+ * есть флаг готовности, который выставляется после конструирования элемента.
+ * Clear и уничтожение вектора с другими потоками не синхронизируются. Аллокатор
+ * вызывается из разных потоков и должен быть потокобезопасным.
+ * @tparam T Тип элемента вектора.
+ * @tparam Allocator Тип аллокатора.
+ * @tparam FirstSegmentSize Вместимость первого сегмента, степень двойки.
+ */
+template <typename T, typename Allocator = std::allocator<T>, size_t FirstSegmentSize = 64U>
+class ConcurrentVector {
+public:
+    using allocator_type = Allocator; //!< Тип аллокатора.
+
+    using Layout = GeometricSegments<FirstSegmentSize>; //!< Раскладка индексов по сегментам.
+
+    /**
+     * @brief Конструирует пустой вектор.
+     * @param alloc Аллокатор.
+     */
+    explicit ConcurrentVector(const Allocator &alloc = Allocator()) noexcept;
+
+    //! Запрет на копирование.
+    ConcurrentVector(const ConcurrentVector &) = delete;
+    //! Запрет на копирование.
+    ConcurrentVector &operator=(const ConcurrentVector &) = delete;
+
+    /**
+     * @brief Уничтожает элементы и освобождает сегменты.
+     */
+    ~ConcurrentVector();
+
+    /**
+     * @brief Конструирует элемент в конце вектора.
+     * @details Потокобезопасно и без блокировок, кроме выделения нового сегмента. Если
+     * конструктор элемента бросит исключение, занятый индекс останется пустой ячейкой,
+     * которую ForEach пропускает.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param args Аргументы для конструирования объекта.
+     * @return ссылку на сконструированный объект, которая не меняется при росте вектора.
+     */
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Вставить объект в конец вектора.
+     * @tparam Obj Тип объекта для вставки.
+     * @param value Объект для вставки.
+     * @return ссылку на вставленный объект.
+     */
+    template <typename Obj>
+    T &PushBack(Obj &&value);
+
+    /**
+     * @brief Заранее выделяет сегменты под указанное количество элементов.
+     * @details Потокобезопасно. Позволяет убрать выделение памяти с горячего пути добавления.
+     * @param new_capacity Вместимость.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Обходит готовые элементы в порядке индексов.
+     * @details Потокобезопасно относительно EmplaceBack: элементы, которые ещё
+     * конструируются, пропускаются.
+     * @tparam Func Тип функции, принимающей индекс и ссылку на элемент.
+     * @param func Функция.
+     */
+    template <typename Func>
+    void ForEach(Func func) const;
+
+    /**
+     * @brief Уничтожает все элементы, сохраняя сегменты.
+     * @details Нельзя вызывать одновременно с другими методами.
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Получает количество занятых индексов.
+     * @details Включает элементы, которые ещё конструируются другими потоками.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Проверяет, сконструирован ли элемент с указанным индексом.
+     * @param index Индекс элемента.
+     * @return true, если элемент готов и его можно читать.
+     */
+    [[nodiscard]] bool IsReady(size_t index) const noexcept;
+
+    /**
+     * @brief Получает доступ к элементу по индексу.
+     * @details Элемент должен быть готов: возвращён EmplaceBack в этом потоке или
+     * проверен IsReady.
+     * @param index Индекс элемента.
+     * @return ссылку на элемент.
+     */
+    T &operator[](size_t index) noexcept;
+
+    //! @overload ConcurrentVector::operator[](size_t index)
+    const T &operator[](size_t index) const noexcept;
+
+private:
+    /**
+     * @brief Сегмент: память под элементы и их флаги готовности.
+     */
+    struct Segment {
+        RawMemory<T, Allocator> elements; //!< Память под элементы.
+        std::unique_ptr<std::atomic<bool>[]> ready; //!< Флаги готовности элементов.
+
+        //! Выделяет сегмент указанной вместимости.
+        Segment(size_t capacity, const Allocator &alloc)
+            : elements(capacity, alloc)
+            , ready(std::make_unique<std::atomic<bool>[]>(capacity)) {
+        }
+    };
+
+    using Location = typename Layout::Location; //!< Положение элемента.
+
+    [[no_unique_address]] Allocator alloc_; //!< Аллокатор.
+    std::array<std::atomic<Segment *>, Layout::MAX_SEGMENTS> segments_{}; //!< Сегменты, nullptr - не выделен.
+    //! Владелец сегмента не смог его выделить, сегмент выделяет любой нуждающийся поток.
+    std::array<std::atomic<bool>, Layout::MAX_SEGMENTS> orphaned_{};
+    std::atomic<size_t> size_ = 0U; //!< Количество занятых индексов.
+
+    /**
+     * @brief Получает сегмент, в который попал занятый индекс.
+     * @details Сегмент выделяет только поток, занявший его первый индекс. Остальные ждут,
+     * пока он опубликует сегмент, и не выделяют лишних копий. Если у владельца выделение
+     * бросило исключение, сегмент выделяют ожидающие потоки.
+     * @param location Положение занятого индекса.
+     * @return сегмент.
+     */
+    Segment &AcquireSegment(Location location);
+
+    /**
+     * @brief Получает сегмент, выделяя его, если его ещё нет.
+     * @details Потоки, выделившие сегмент одновременно, освобождают проигравшие копии.
+     * @param segment Номер сегмента.
+     * @return сегмент.
+     */
+    Segment &EnsureSegment(size_t segment);
+
+    /**
+     * @brief Уничтожает готовые элементы.
+     */
+    void DestroyElements() noexcept;
+};
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+ConcurrentVector<T, Allocator, FirstSegmentSize>::ConcurrentVector(const Allocator &alloc) noexcept
+: alloc_(alloc) {
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+ConcurrentVector<T, Allocator, FirstSegmentSize>::~ConcurrentVector() {
+    DestroyElements();
+    for (std::atomic<Segment *> &segment : segments_) {
+        delete segment.load(std::memory_order_relaxed);
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+template <typename... Args>
+T &ConcurrentVector<T, Allocator, FirstSegmentSize>::EmplaceBack(Args &&...args) {
+    const size_t index = size_.fetch_add(1U, std::memory_order_relaxed);
+    const Location location = Layout::Locate(index);
+    Segment &segment = AcquireSegment(location);
+    T *const slot = segment.elements + location.offset;
+    new (slot) T(std::forward<Args>(args)...);
+    segment.ready[location.offset].store(true, std::memory_order_release);
+    return *slot;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+template <typename Obj>
+T &ConcurrentVector<T, Allocator, FirstSegmentSize>::PushBack(Obj &&value) {
+    return EmplaceBack(std::forward<Obj>(value));
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void ConcurrentVector<T, Allocator, FirstSegmentSize>::Reserve(const size_t new_capacity) {
+    if (new_capacity == 0U) {
+        return;
+    }
+    const size_t last_segment = Layout::Locate(new_capacity - 1U).segment;
+    for (size_t segment = 0; segment <= last_segment; ++segment) {
+        EnsureSegment(segment);
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+template <typename Func>
+void ConcurrentVector<T, Allocator, FirstSegmentSize>::ForEach(Func func) const {
+    const size_t size = size_.load(std::memory_order_acquire);
+    size_t first = 0U;
+    for (size_t segment = 0; first < size; ++segment) {
+        const size_t capacity = Layout::Capacity(segment);
+        const Segment *const current = segments_[segment].load(std::memory_order_acquire);
+        if (current != nullptr) {
+            const size_t count = std::min(capacity, size - first);
+            for (size_t offset = 0; offset < count; ++offset) {
+                if (current->ready[offset].load(std::memory_order_acquire)) {
+                    func(first + offset, current->elements[offset]);
+                }
+            }
+        }
+        first += capacity;
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void ConcurrentVector<T, Allocator, FirstSegmentSize>::Clear() noexcept {
+    DestroyElements();
+    size_.store(0U, std::memory_order_relaxed);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+size_t ConcurrentVector<T, Allocator, FirstSegmentSize>::Size() const noexcept {
+    return size_.load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+bool ConcurrentVector<T, Allocator, FirstSegmentSize>::IsReady(const size_t index) const noexcept {
+    const Location location = Layout::Locate(index);
+    const Segment *const segment = segments_[location.segment].load(std::memory_order_acquire);
+    return segment != nullptr && segment->ready[location.offset].load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+T &ConcurrentVector<T, Allocator, FirstSegmentSize>::operator[](const size_t index) noexcept {
+    assert(IsReady(index));
+    const Location location = Layout::Locate(index);
+    return segments_[location.segment].load(std::memory_order_acquire)->elements[location.offset];
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+const T &ConcurrentVector<T, Allocator, FirstSegmentSize>::operator[](const size_t index) const noexcept {
+    return const_cast<ConcurrentVector &>(*this)[index];
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename ConcurrentVector<T, Allocator, FirstSegmentSize>::Segment &
+ConcurrentVector<T, Allocator, FirstSegmentSize>::AcquireSegment(const Location location) {
+    std::atomic<Segment *> &slot = segments_[location.segment];
+    if (location.offset == 0U) {
+        try {
+            return EnsureSegment(location.segment);
+        } catch (...) {
+            orphaned_[location.segment].store(true, std::memory_order_release);
+            throw;
+        }
+    }
+    // Ожидание длится не дольше одного выделения памяти владельцем
+    Segment *current = slot.load(std::memory_order_acquire);
+    while (current == nullptr) {
+        if (orphaned_[location.segment].load(std::memory_order_acquire)) {
+            return EnsureSegment(location.segment);
+        }
+        std::this_thread::yield();
+        current = slot.load(std::memory_order_acquire);
+    }
+    return *current;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename ConcurrentVector<T, Allocator, FirstSegmentSize>::Segment &
+ConcurrentVector<T, Allocator, FirstSegmentSize>::EnsureSegment(const size_t segment) {
+    Segment *current = segments_[segment].load(std::memory_order_acquire);
+    if (current != nullptr) {
+        return *current;
+    }
+    auto created = std::make_unique<Segment>(Layout::Capacity(segment), alloc_);
+    if (segments_[segment].compare_exchange_strong(current, created.get(), std::memory_order_acq_rel,
+                                                   std::memory_order_acquire)) {
+        return *created.release();
+    }
+    // Сегмент уже выделил другой поток (Reserve или после сбоя владельца), наш освобождается
+    return *current;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void ConcurrentVector<T, Allocator, FirstSegmentSize>::DestroyElements() noexcept {
+    const size_t size = size_.load(std::memory_order_relaxed);
+    size_t first = 0U;
+    for (size_t segment = 0; first < size; ++segment) {
+        Segment *const current = segments_[segment].load(std::memory_order_relaxed);
+        const size_t capacity = Layout::Capacity(segment);
+        if (current != nullptr) {
+            const size_t count = std::min(capacity, size - first);
+            for (size_t offset = 0; offset < count; ++offset) {
+                if (current->ready[offset].exchange(false, std::memory_order_relaxed)) {
+                    std::destroy_at(current->elements + offset);
+                }
+            }
+        }
+        first += capacity;
+    }
+}
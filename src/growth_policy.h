@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+
+/**
+ * @file
+ * @brief Стратегии роста вместимости вектора.
+ * @details Стратегия - это тип со статическим методом
+ * @code
+ * static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept;
+ * @endcode
+ * который по текущей вместимости, требуемому количеству элементов и размеру элемента в байтах
+ * возвращает новую вместимость, не меньшую required.
+ *
+ * Стратегия может также уменьшать вместимость, если у неё есть статический метод
+ * @code
+ * static size_t ShrinkCapacity(size_t capacity, size_t size, size_t element_size) noexcept;
+ * @endcode
+ * возвращающий вместимость, до которой нужно уменьшить вектор, или capacity, если уменьшать
+ * не нужно. Vector спрашивает его после каждого удаления элементов.
+ */
+
+/**
+ * @brief Стратегия роста, умеющая уменьшать вместимость.
+ * @tparam GrowthPolicy Стратегия роста.
+ */
+template <typename GrowthPolicy>
+concept ShrinkingGrowthPolicy = requires(size_t n) {
+    { GrowthPolicy::ShrinkCapacity(n, n, n) } noexcept -> std::same_as<size_t>;
+};
+
+/**
+ * @brief Рост в два раза.
+ * @details Минимум перевыделений ценой до двукратного запаса памяти.
+ */
+struct DoublingGrowth {
+    /**
+     * @brief Вычисляет новую вместимость.
+     * @param capacity Текущая вместимость.
+     * @param required Требуемое количество элементов.
+     * @param element_size Размер элемента в байтах.
+     * @return новую вместимость, не меньшую required.
+     */
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept;
+};
+
+/**
+ * @brief Рост в полтора раза.
+ * @details Меньший пиковый расход памяти, а освобождённые ранее блоки со временем
+ * могут быть переиспользованы аллокатором под новый буфер.
+ */
+struct OneAndHalfGrowth {
+    //! @copydoc DoublingGrowth::NextCapacity
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept;
+};
+
+/**
+ * @brief Рост в полтора раза с округлением до размерного класса аллокатора.
+ * @details Размер буфера в байтах округляется вверх до ближайшего размерного класса
+ * (четыре класса на каждую степень двойки, как в jemalloc/tcmalloc), а крупные буферы -
+ * до целого числа страниц. Память, которую аллокатор всё равно выделил бы на округление,
+ * становится полезной вместимостью.
+ */
+struct SizeClassGrowth {
+    static constexpr size_t PAGE_SIZE = 4096U; //!< Размер страницы.
+
+    //! @copydoc DoublingGrowth::NextCapacity
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept;
+
+    /**
+     * @brief Округляет размер блока вверх до размерного класса.
+     * @param bytes Размер блока в байтах.
+     * @return размер размерного класса в байтах.
+     */
+    static size_t RoundToSizeClass(size_t bytes) noexcept;
+};
+
+/**
+ * @brief Рост в два раза до порога, затем на фиксированное приращение.
+ * @details Ограничивает запас памяти у больших векторов величиной Increment элементов.
+ * @tparam Threshold Вместимость в элементах, после которой рост становится линейным.
+ * @tparam Increment Приращение вместимости в элементах после порога.
+ */
+template <size_t Threshold, size_t Increment>
+struct FixedIncrementGrowth {
+    static_assert(Increment > 0U);
+
+    //! @copydoc DoublingGrowth::NextCapacity
+    static size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept;
+};
+
+/**
+ * @brief Стратегия роста, уменьшающая вместимость с гистерезисом.
+ * @details Когда размер падает ниже capacity / Divisor, вместимость уменьшается до удвоенного
+ * размера. Между порогами роста и уменьшения остаётся зазор, поэтому чередование вставок
+ * и удалений около порога не приводит к постоянным перевыделениям. Долгоживущие векторы,
+ * например кэши, перестают удерживать память пикового размера. Уменьшение переносит
+ * элементы, поэтому удаление делает недействительными все итераторы.
+ * @tparam Growth Стратегия роста вместимости.
+ * @tparam Divisor Во сколько раз размер должен стать меньше вместимости для её уменьшения.
+ * @tparam MinCapacity Вместимость в элементах, ниже которой вектор не уменьшается.
+ */
+template <typename Growth = DoublingGrowth, size_t Divisor = 4U, size_t MinCapacity = 16U>
+struct HysteresisShrink : Growth {
+    static_assert(Divisor > 2U, "shrinking to twice the size must free memory");
+
+    /**
+     * @brief Вычисляет вместимость после удаления элементов.
+     * @param capacity Текущая вместимость.
+     * @param size Текущий размер.
+     * @param element_size Размер элемента в байтах.
+     * @return новую вместимость, не меньшую size, или capacity, если уменьшать не нужно.
+     */
+    static size_t ShrinkCapacity(size_t capacity, size_t size, size_t element_size) noexcept;
+};
+
+inline size_t DoublingGrowth::NextCapacity(const size_t capacity, const size_t required,
+                                           const size_t /*element_size*/) noexcept {
+    return std::max(required, (capacity == 0U) ? 1U : (capacity * 2U));
+}
+
+inline size_t OneAndHalfGrowth::NextCapacity(const size_t capacity, const size_t required,
+                                             const size_t /*element_size*/) noexcept {
+    return std::max(required, capacity + std::max<size_t>(capacity / 2U, 1U));
+}
+
+inline size_t SizeClassGrowth::NextCapacity(const size_t capacity, const size_t required,
+                                            const size_t element_size) noexcept {
+    const size_t target = std::max(required, capacity + std::max<size_t>(capacity / 2U, 1U));
+    return std::max(target, RoundToSizeClass(target * element_size) / element_size);
+}
+
+inline size_t SizeClassGrowth::RoundToSizeClass(const size_t bytes) noexcept {
+    if (bytes <= 16U) {
+        return 16U;
+    }
+    if (bytes >= PAGE_SIZE) {
+        return (bytes + PAGE_SIZE - 1U) / PAGE_SIZE * PAGE_SIZE;
+    }
+    size_t power = 16U;
+    while (power * 2U < bytes) {
+        power *= 2U;
+    }
+    // Между power и 2 * power лежат четыре размерных класса
+    const size_t step = power / 4U;
+    return (bytes + step - 1U) / step * step;
+}
+
+template <size_t Threshold, size_t Increment>
+size_t FixedIncrementGrowth<Threshold, Increment>::NextCapacity(const size_t capacity,
+                                                                const size_t required,
+                                                                const size_t /*element_size*/) noexcept {
+    if (capacity < Threshold) {
+        return std::max(required, std::min(Threshold, (capacity == 0U) ? 1U : (capacity * 2U)));
+    }
+    return std::max(required, capacity + Increment);
+}
+
+template <typename Growth, size_t Divisor, size_t MinCapacity>
+size_t HysteresisShrink<Growth, Divisor, MinCapacity>::ShrinkCapacity(const size_t capacity, const size_t size,
+                                                                      const size_t /*element_size*/) noexcept {
+    if (capacity <= MinCapacity || size >= capacity / Divisor) {
+        return capacity;
+    }
+    return std::max(size * 2U, MinCapacity);
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+//! Размер большой страницы на x86-64 и AArch64 с гранулой 4 КиБ.
+inline constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20U;
+
+/**
+ * @brief Аллокатор, размещающий крупные блоки на больших страницах.
+ * @details Блоки от ThresholdBytes байт отображаются через mmap с выравниванием на 2 МиБ
+ * и помечаются madvise(MADV_HUGEPAGE), чтобы ядро подкладывало под них прозрачные большие
+ * страницы, что резко сокращает промахи TLB при произвольном доступе. Если UseHugeTlb == true,
+ * сначала пробуется MAP_HUGETLB из заранее зарезервированного пула, а при его исчерпании -
+ * обычный путь. Меньшие блоки выделяются через std::allocator. Вне Linux всегда используется
+ * std::allocator.
+ * @tparam T Тип объекта, который будет размещаться в памяти.
+ * @tparam ThresholdBytes Размер блока в байтах, начиная с которого используются большие страницы.
+ * @tparam UseHugeTlb Пробовать ли явные большие страницы MAP_HUGETLB.
+ */
+template <typename T, size_t ThresholdBytes = HUGE_PAGE_SIZE, bool UseHugeTlb = false>
+class HugePageAllocator {
+public:
+    using value_type = T; //!< Тип объекта.
+    using is_always_equal = std::true_type; //!< Аллокатор не имеет состояния.
+
+    static_assert(alignof(T) <= HUGE_PAGE_SIZE);
+
+    /**
+     * @brief Аллокатор для другого типа с теми же настройками.
+     * @tparam U Тип объекта.
+     */
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, ThresholdBytes, UseHugeTlb>; //!< Тип аллокатора.
+    };
+
+    HugePageAllocator() noexcept = default;
+
+    //! Конструктор преобразования из аллокатора для другого типа.
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, ThresholdBytes, UseHugeTlb> & /*other*/) noexcept {  // NOLINT
+    }
+
+    /**
+     * @brief Выделяет сырую память под указанное количество элементов.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     * @throw std::bad_alloc если память выделить не удалось.
+     */
+    T *allocate(size_t n);
+
+    /**
+     * @brief Выделяет заполненную нулями память под указанное количество элементов.
+     * @details Блоки на больших страницах отображаются через mmap и уже обнулены ядром,
+     * небольшие обнуляются явно.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     * @throw std::bad_alloc если память выделить не удалось.
+     */
+    T *allocate_zeroed(size_t n);
+
+    /**
+     * @brief Освобождает память, выделенную ранее при помощи allocate.
+     * @param p Указатель на память.
+     * @param n Количество элементов, под которое выделялась память.
+     */
+    void deallocate(T *p, size_t n) noexcept;
+
+    /**
+     * @brief Проверяет, размещается ли блок указанного размера на больших страницах.
+     * @param n Количество элементов.
+     * @return true, если блок отображается через mmap.
+     */
+    static bool IsHuge(size_t n) noexcept;
+
+    //! Все экземпляры взаимозаменяемы.
+    template <typename U>
+    bool operator==(const HugePageAllocator<U, ThresholdBytes, UseHugeTlb> & /*other*/) const noexcept {
+        return true;
+    }
+
+private:
+    /**
+     * @brief Округляет размер блока вверх до целого числа больших страниц.
+     * @param n Количество элементов.
+     * @return размер отображения в байтах.
+     */
+    static size_t MappingBytes(size_t n) noexcept;
+};
+
+template <typename T, size_t ThresholdBytes, bool UseHugeTlb>
+bool HugePageAllocator<T, ThresholdBytes, UseHugeTlb>::IsHuge(const size_t n) noexcept {
+#if defined(__linux__)
+    return n * sizeof(T) >= ThresholdBytes;
+#else
+    return false;
+#endif
+}
+
+template <typename T, size_t ThresholdBytes, bool UseHugeTlb>
+size_t HugePageAllocator<T, ThresholdBytes, UseHugeTlb>::MappingBytes(const size_t n) noexcept {
+    return (n * sizeof(T) + HUGE_PAGE_SIZE - 1U) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+template <typename T, size_t ThresholdBytes, bool UseHugeTlb>
+T *HugePageAllocator<T, ThresholdBytes, UseHugeTlb>::allocate(const size_t n) {
+    if (n > (static_cast<size_t>(-1) - 2U * HUGE_PAGE_SIZE) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    if (!IsHuge(n)) {
+        std::allocator<T> alloc;
+        return alloc.allocate(n);
+    }
+#if defined(__linux__)
+    const size_t bytes = MappingBytes(n);
+    if constexpr (UseHugeTlb) {
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            return static_cast<T *>(p);
+        }
+    }
+
+    // Отображаем с запасом в одну большую страницу и обрезаем края до выровненного участка
+    const size_t padded_bytes = bytes + HUGE_PAGE_SIZE;
+    void *raw = mmap(nullptr, padded_bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    auto *const raw_begin = static_cast<std::byte *>(raw);
+    const size_t head = (HUGE_PAGE_SIZE - reinterpret_cast<uintptr_t>(raw) % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    std::byte *const begin = raw_begin + head;
+    if (head != 0U) {
+        munmap(raw_begin, head);
+    }
+    munmap(begin + bytes, padded_bytes - head - bytes);
+#if defined(MADV_HUGEPAGE)
+    madvise(begin, bytes, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<T *>(begin);
+#else
+    return nullptr;
+#endif
+}
+
+template <typename T, size_t ThresholdBytes, bool UseHugeTlb>
+T *HugePageAllocator<T, ThresholdBytes, UseHugeTlb>::allocate_zeroed(const size_t n) {
+    T *p = allocate(n);
+    if (!IsHuge(n)) {
+        std::memset(static_cast<void *>(p), 0, n * sizeof(T));
+    }
+    return p;
+}
+
+template <typename T, size_t ThresholdBytes, bool UseHugeTlb>
+void HugePageAllocator<T, ThresholdBytes, UseHugeTlb>::deallocate(T *const p, const size_t n) noexcept {
+    if (!IsHuge(n)) {
+        std::allocator<T> alloc;
+        alloc.deallocate(p, n);
+        return;
+    }
+#if defined(__linux__)
+    munmap(p, MappingBytes(n));
+#endif
+}
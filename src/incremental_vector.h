@@ -0,0 +1,445 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Вектор, который переносит элементы при росте постепенно.
+ * @details Обычный Vector при росте переносит все элементы разом, и один EmplaceBack на
+ * большом векторе останавливается на время копирования всего буфера. IncrementalVector
+ * при росте только выделяет новый буфер и оставляет старый живым: элементы [0, migrated)
+ * уже лежат в новом буфере, [migrated, old_size) ещё в старом, а добавленные после роста -
+ * в новом. Каждый последующий EmplaceBack и PopBack переносит не больше MigrationStep
+ * элементов, после чего старый буфер освобождается. При удвоении вместимости перенос
+ * заканчивается задолго до следующего роста, поэтому худшее время EmplaceBack ограничено
+ * выделением памяти и MigrationStep релокациями. Если стратегия растёт медленнее и рост
+ * наступил раньше, новый элемент создаётся в третьем буфере, а прошлый перенос
+ * заканчивается разом.
+ * Ограничивается именно худшее время, а не хвост распределения: перенос размазан по
+ * добавлениям, поэтому p99.9 не лучше, чем у Vector.
+ * Доступ по индексу проверяет, в каком буфере лежит элемент. Непрерывный участок памяти
+ * дают только begin, end и Data: они сначала заканчивают перенос.
+ * @tparam T Тип элемента вектора.
+ * @tparam Allocator Тип аллокатора.
+ * @tparam GrowthPolicy Стратегия роста вместимости.
+ * @tparam MigrationStep Наибольшее количество элементов, переносимых за одну операцию.
+ */
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          size_t MigrationStep = 2U>
+class IncrementalVector {
+public:
+    using iterator = T *; //!< Итератор.
+    using const_iterator = const T *; //!< Константный итератор.
+    using allocator_type = Allocator; //!< Тип аллокатора.
+
+    static_assert(MigrationStep != 0U, "Migration step must be positive");
+
+    /**
+     * @brief Конструирует пустой вектор.
+     */
+    IncrementalVector() = default;
+
+    /**
+     * @brief Конструирует пустой вектор с указанным аллокатором.
+     * @param alloc Аллокатор.
+     */
+    explicit IncrementalVector(const Allocator &alloc) noexcept;
+
+    /**
+     * @brief Конструирует объект, копируя переданный.
+     * @param other Объект для копирования.
+     */
+    IncrementalVector(const IncrementalVector &other);
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @details Незаконченный перенос переходит к новому объекту.
+     * @param other Объект для перемещения.
+     */
+    IncrementalVector(IncrementalVector &&other) noexcept;
+
+    /**
+     * @brief Присваивает объект, копируя себе содержимое переданного.
+     * @param rhs Объект для копирования.
+     * @return текущий объект.
+     */
+    IncrementalVector &operator=(const IncrementalVector &rhs);
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @param rhs Объект для перемещения.
+     * @return текущий объект.
+     */
+    IncrementalVector &operator=(IncrementalVector &&rhs) noexcept;
+
+    /**
+     * @brief Деструктор.
+     */
+    ~IncrementalVector();
+
+    /**
+     * @brief Получить итератор на начало вектора.
+     * @details Заканчивает перенос, чтобы элементы лежали непрерывно.
+     * @return итератор на начало вектора.
+     */
+    iterator begin();
+
+    /**
+     * @brief Получить итератор на конец вектора.
+     * @details Заканчивает перенос, чтобы элементы лежали непрерывно.
+     * @return итератор на конец вектора.
+     */
+    iterator end();
+
+    /**
+     * @brief Получает указатель на первый элемент.
+     * @details Заканчивает перенос, чтобы элементы лежали непрерывно.
+     * @return указатель на первый элемент.
+     */
+    T *Data();
+
+    /**
+     * @brief Меняет местами содержимое текущего объекта с содержимым переданного.
+     * @param other Объект, с которым нужно поменяться содержимым.
+     */
+    void Swap(IncrementalVector &other) noexcept;
+
+    /**
+     * @brief Резервирует место под указанное количество элементов.
+     * @details Переносит элементы разом: явный Reserve стоит O(n), как у Vector.
+     * @param new_capacity Новая вместимость вектора.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Вставить объект в конец вектора.
+     * @tparam Obj Тип объекта для вставки.
+     * @param value Объект для вставки.
+     */
+    template <typename Obj>
+    void PushBack(Obj &&value);
+
+    /**
+     * @brief Конструирует и вставляет объект в конец вектора.
+     * @details Аргументы могут ссылаться на элементы вектора. Даёт строгую гарантию безопасности.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param args Аргументы для конструирования объекта.
+     * @return возвращает ссылку на сконструированный объект.
+     */
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Удаляет последний элемент.
+     */
+    void PopBack() noexcept;
+
+    /**
+     * @brief Уничтожает все элементы и освобождает старый буфер, если перенос не закончен.
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Переносит разом все элементы, оставшиеся в старом буфере.
+     */
+    void FinishMigration();
+
+    /**
+     * @brief Проверяет, идёт ли перенос.
+     * @return true, если старый буфер ещё жив.
+     */
+    [[nodiscard]] bool IsMigrating() const noexcept;
+
+    /**
+     * @brief Получает размер.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Получает вместимость нового буфера.
+     * @return вместимость.
+     */
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /**
+     * @brief Получает доступ к элементу по индексу.
+     * @param index Индекс элемента.
+     * @return ссылку на элемент.
+     */
+    T &operator[](size_t index) noexcept;
+
+    //! @overload IncrementalVector::operator[](size_t index)
+    const T &operator[](size_t index) const noexcept;
+
+    /**
+     * @brief Получает аллокатор.
+     * @return копию аллокатора.
+     */
+    [[nodiscard]] Allocator GetAllocator() const noexcept;
+
+private:
+    RawMemory<T, Allocator> data_; //!< Новый буфер.
+    RawMemory<T, Allocator> old_data_; //!< Старый буфер, пустой, если перенос не идёт.
+    size_t size_ = 0U; //!< Размер.
+    size_t old_size_ = 0U; //!< Конец ещё не перенесённых элементов.
+    size_t migrated_ = 0U; //!< Количество перенесённых элементов.
+
+    //! Переносит ли релокация без исключений.
+    static constexpr bool NOTHROW_RELOCATION = IS_TRIVIALLY_RELOCATABLE<T> || std::is_nothrow_move_constructible_v<T>;
+
+    /**
+     * @brief Получает адрес элемента в том буфере, где он сейчас лежит.
+     * @param index Индекс элемента.
+     * @return адрес.
+     */
+    T *Slot(size_t index) noexcept;
+
+    /**
+     * @brief Переносит не больше указанного количества элементов в новый буфер.
+     * @details При исключении элементы этого шага остаются в старом буфере.
+     * @param count Наибольшее количество элементов.
+     */
+    void Migrate(size_t count);
+
+    /**
+     * @brief Уничтожает элементы, начиная с new_size, и уменьшает размер.
+     * @param new_size Новый размер вектора.
+     */
+    void DestroyFrom(size_t new_size) noexcept;
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(const Allocator &alloc) noexcept
+: data_(alloc)
+, old_data_(alloc) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(const IncrementalVector &other)
+: IncrementalVector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.GetAllocator())) {
+    Reserve(other.size_);
+    try {
+        for (size_t i = 0; i < other.size_; ++i) {
+            EmplaceBack(other[i]);
+        }
+    } catch (...) {
+        Clear();
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IncrementalVector(IncrementalVector &&other) noexcept
+: data_(std::move(other.data_))
+, old_data_(std::move(other.old_data_))
+, size_(std::exchange(other.size_, 0U))
+, old_size_(std::exchange(other.old_size_, 0U))
+, migrated_(std::exchange(other.migrated_, 0U)) {
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep> &
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::operator=(const IncrementalVector &rhs) {
+    if (this != &rhs) {
+        IncrementalVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep> &
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::operator=(IncrementalVector &&rhs) noexcept {
+    if (this != &rhs) {
+        IncrementalVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::~IncrementalVector() {
+    Clear();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::iterator
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::begin() {
+    return Data();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+typename IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::iterator
+IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::end() {
+    return Data() + size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+T *IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Data() {
+    FinishMigration();
+    return data_.GetAddress();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Swap(IncrementalVector &other) noexcept {
+    data_.Swap(other.data_);
+    old_data_.Swap(other.old_data_);
+    std::swap(size_, other.size_);
+    std::swap(old_size_, other.old_size_);
+    std::swap(migrated_, other.migrated_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Reserve(const size_t new_capacity) {
+    if (new_capacity <= data_.Capacity()) {
+        return;
+    }
+    FinishMigration();
+    RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+    UninitializedRelocate(data_.GetAddress(), size_, new_data.GetAddress());
+    DestroyRelocated(data_.GetAddress(), size_);
+    data_.Swap(new_data);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+template <typename Obj>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::PushBack(Obj &&value) {
+    EmplaceBack(std::forward<Obj>(value));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+template <typename... Args>
+T &IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::EmplaceBack(Args &&...args) {
+    T *slot = nullptr;
+    if (size_ != data_.Capacity()) {
+        slot = new (data_ + size_) T(std::forward<Args>(args)...);
+    } else {
+        RawMemory<T, Allocator> new_data(
+            GrowthPolicy::NextCapacity(data_.Capacity(), size_ + 1U, sizeof(T)), data_.GetAllocator());
+        // Элемент создаётся до переноса: аргументы могут ссылаться на элементы обоих буферов
+        slot = new (new_data + size_) T(std::forward<Args>(args)...);
+        if (IsMigrating()) {
+            // Прошлый перенос не успел закончиться: стратегия роста медленнее удвоения
+            try {
+                FinishMigration();
+            } catch (...) {
+                std::destroy_at(slot);
+                throw;
+            }
+        }
+        data_.Swap(new_data);
+        old_data_.Swap(new_data);
+        old_size_ = size_;
+    }
+    ++size_;
+    if constexpr (NOTHROW_RELOCATION) {
+        Migrate(MigrationStep);
+    } else {
+        try {
+            Migrate(MigrationStep);
+        } catch (...) {
+            --size_;
+            std::destroy_at(slot);
+            throw;
+        }
+    }
+    return *slot;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::PopBack() noexcept {
+    assert(size_ != 0U);
+    DestroyFrom(size_ - 1U);
+    if constexpr (NOTHROW_RELOCATION) {
+        Migrate(MigrationStep);
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Clear() noexcept {
+    DestroyFrom(0U);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::FinishMigration() {
+    Migrate(old_size_ - migrated_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+bool IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::IsMigrating() const noexcept {
+    return old_data_.GetAddress() != nullptr;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+size_t IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Size() const noexcept {
+    return size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+size_t IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Capacity() const noexcept {
+    return data_.Capacity();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+T &IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::operator[](const size_t index) noexcept {
+    assert(index < size_);
+    return *Slot(index);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+const T &IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::operator[](const size_t index) const noexcept {
+    return const_cast<IncrementalVector &>(*this)[index];
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+Allocator IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::GetAllocator() const noexcept {
+    return data_.GetAllocator();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+T *IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Slot(const size_t index) noexcept {
+    // Одно беззнаковое сравнение проверяет migrated_ <= index < old_size_
+    if (index - migrated_ < old_size_ - migrated_) {
+        return old_data_ + index;
+    }
+    return data_ + index;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::Migrate(const size_t count) {
+    if (!IsMigrating()) {
+        return;
+    }
+    const size_t n = std::min(count, old_size_ - migrated_);
+    UninitializedRelocate(old_data_ + migrated_, n, data_ + migrated_);
+    DestroyRelocated(old_data_ + migrated_, n);
+    migrated_ += n;
+    if (migrated_ == old_size_) {
+        old_data_ = RawMemory<T, Allocator>(data_.GetAllocator());
+        old_size_ = 0U;
+        migrated_ = 0U;
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t MigrationStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrationStep>::DestroyFrom(const size_t new_size) noexcept {
+    for (size_t index = new_size; index < size_; ++index) {
+        std::destroy_at(Slot(index));
+    }
+    size_ = new_size;
+    if (old_size_ > new_size) {
+        old_size_ = std::max(new_size, migrated_);
+        // Переносить больше нечего: пустой шаг освобождает старый буфер
+        Migrate(0U);
+    }
+}
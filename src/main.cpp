@@ -1,8 +1,36 @@
+#include "adaptive_vector.h"
+#include "aligned_vector.h"
+#include "arena.h"
+#include "buffer_pool.h"
+#include "call_site_profiler.h"
+#include "concurrent_vector.h"
+#include "huge_page_allocator.h"
+#include "incremental_vector.h"
+#include "malloc_allocator.h"
+#include "mapped_vector.h"
+#include "pinned_vector.h"
+#include "segmented_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
 #include "vector.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 namespace {
@@ -559,84 +587,1777 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+namespace {
+
+// Аллокатор с состоянием: ведёт учёт выделенных байт в своей "арене"
+template <typename T, bool Propagate>
+struct TrackingAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_swap = std::bool_constant<Propagate>;
+
+    explicit TrackingAllocator(int id = 0) noexcept
+        : id(id)
+    {
+    }
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U, Propagate>& other) noexcept  // NOLINT
+        : id(other.id)
+    {
+    }
+
+    T* allocate(size_t n) {
+        allocated_bytes[id] += n * sizeof(T);
+        return static_cast<T*>(operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        allocated_bytes[id] -= n * sizeof(T);
+        operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const TrackingAllocator<U, Propagate>& other) const noexcept {
+        return id == other.id;
+    }
+
+    int id = 0;
+
+    static inline size_t allocated_bytes[3] = {};
+};
+
+}  // namespace
+
+void Test7() {
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        using Alloc = TrackingAllocator<int, true>;
+        {
+            Vector<int, Alloc> v(SIZE, Alloc{1});
+            assert(Alloc::allocated_bytes[1] == SIZE * sizeof(int));
+            v.PushBack(ID);
+            assert(Alloc::allocated_bytes[1] == SIZE * 2 * sizeof(int));
+            assert(v.GetAllocator().id == 1);
+
+            Vector<int, Alloc> v_copy(v);
+            assert(v_copy.GetAllocator().id == 1);
+            assert(v_copy[SIZE] == ID);
+
+            Vector<int, Alloc> v_other(SIZE, Alloc{2});
+            v_other = v;
+            assert(v_other.GetAllocator().id == 1);
+            assert(Alloc::allocated_bytes[2] == 0);
+
+            Vector<int, Alloc> v_moved(Alloc{2});
+            v_moved = std::move(v_other);
+            assert(v_moved.GetAllocator().id == 1);
+            assert(v_moved[SIZE] == ID);
+        }
+        assert(Alloc::allocated_bytes[1] == 0);
+        assert(Alloc::allocated_bytes[2] == 0);
+    }
+    {
+        using Alloc = TrackingAllocator<Obj, false>;
+        Obj::ResetCounters();
+        {
+            Vector<Obj, Alloc> v(SIZE, Alloc{1});
+            v[0].id = ID;
+            Vector<Obj, Alloc> v_other(Alloc{2});
+            v_other = v;
+            assert(v_other.GetAllocator().id == 2);
+            assert(v_other[0].id == ID);
+            assert(Alloc::allocated_bytes[2] == SIZE * sizeof(Obj));
+
+            Vector<Obj, Alloc> v_moved(Alloc{2});
+            const int old_num_moved = Obj::num_moved;
+            v_moved = std::move(v);
+            assert(v_moved.GetAllocator().id == 2);
+            assert(v_moved[0].id == ID);
+            assert(Obj::num_moved == old_num_moved + static_cast<int>(SIZE));
+            assert(Alloc::allocated_bytes[2] == 2 * SIZE * sizeof(Obj));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(Alloc::allocated_bytes[1] == 0);
+        assert(Alloc::allocated_bytes[2] == 0);
+    }
+}
+
+namespace {
+
+// Тип с нетривиальными конструкторами, явно помеченный как тривиально релоцируемый
+struct RelocatableObj {
+    explicit RelocatableObj(int id = 0)
+        : id(id)
+    {
+    }
+    RelocatableObj(const RelocatableObj& other)
+        : id(other.id)
+    {
+        ++num_copied;
+    }
+    RelocatableObj(RelocatableObj&& other) noexcept
+        : id(other.id)
+    {
+        ++num_moved;
+    }
+    RelocatableObj& operator=(const RelocatableObj& other) = default;
+    RelocatableObj& operator=(RelocatableObj&& other) = default;
+    ~RelocatableObj() {
+        ++num_destroyed;
+    }
+
+    int id = 0;
+
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
+}  // namespace
+
+template <>
+struct IsTriviallyRelocatable<RelocatableObj> : std::true_type {};
+
+void Test8() {
+    const size_t SIZE = 100;
+    {
+        Vector<RelocatableObj> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Reserve(SIZE * 4);
+        v.Insert(v.cbegin() + 1, RelocatableObj{-1});
+        v.Emplace(v.cbegin() + 2, -2);
+        v.Erase(v.cbegin());
+        assert(v.Size() == SIZE + 1);
+        assert(v[0].id == -1);
+        assert(v[1].id == -2);
+        assert(v[2].id == 1);
+        assert(v[SIZE].id == static_cast<int>(SIZE - 1));
+        assert(RelocatableObj::num_copied == 0);
+        // Перемещался только временный объект, переданный в Insert
+        assert(RelocatableObj::num_moved == 1);
+        assert(RelocatableObj::num_destroyed == 2);
+    }
+    assert(RelocatableObj::num_destroyed == static_cast<int>(SIZE) + 3);
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(std::make_unique<int>(static_cast<int>(i)));
+        }
+        v.Emplace(v.cbegin(), std::make_unique<int>(-1));
+        v.Erase(v.cbegin() + 1);
+        assert(v.Size() == SIZE);
+        assert(*v[0] == -1);
+        assert(*v[1] == 1);
+        assert(*v[SIZE - 1] == static_cast<int>(SIZE - 1));
+    }
+}
+
+void Test9() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin() + 1, ID);
+        assert(v.Size() == SIZE + 2);
+        assert(v[0] == 0);
+        assert(v[1] == ID);
+        assert(v[2] == 1);
+        assert(v[SIZE + 1] == 0);
+
+        Vector<int, MallocAllocator<int>> v_copy(v);
+        assert(v_copy[1] == ID);
+    }
+    {
+        // Переход через порог mmap и рост отображённого блока через mremap
+        const size_t LARGE_SIZE = 4 * MallocAllocator<int>::LARGE_BLOCK_BYTES / sizeof(int);
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v[SIZE - 1] = ID;
+        v.Reserve(LARGE_SIZE);
+        assert(v.Capacity() == LARGE_SIZE);
+        assert(v[SIZE - 1] == ID);
+        v.Resize(LARGE_SIZE);
+        v[LARGE_SIZE - 1] = ID;
+        v.PushBack(ID);
+        assert(v.Capacity() == LARGE_SIZE * 2);
+        assert(v[SIZE - 1] == ID);
+        assert(v[LARGE_SIZE - 1] == ID);
+        assert(v[LARGE_SIZE] == ID);
+    }
+}
+
+void Test10() {
+    {
+        Vector<int, std::allocator<int>, OneAndHalfGrowth> v;
+        std::vector<size_t> capacities;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+            if (capacities.empty() || capacities.back() != v.Capacity()) {
+                capacities.push_back(v.Capacity());
+            }
+        }
+        assert((capacities == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13}));
+        v.Insert(v.cbegin(), -1);
+        v.Insert(v.cbegin(), -1);
+        v.Insert(v.cbegin(), -1);
+        v.Insert(v.cbegin(), -1);
+        assert(v.Capacity() == 19);
+        assert(v[0] == -1);
+        assert(v[4] == 0);
+    }
+    {
+        Vector<int, std::allocator<int>, FixedIncrementGrowth<8, 5>> v;
+        for (int i = 0; i < 9; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 13);
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 18);
+    }
+    {
+        assert(SizeClassGrowth::RoundToSizeClass(1) == 16);
+        assert(SizeClassGrowth::RoundToSizeClass(17) == 20);
+        assert(SizeClassGrowth::RoundToSizeClass(100) == 112);
+        assert(SizeClassGrowth::RoundToSizeClass(4097) == 8192);
+        Vector<char, std::allocator<char>, SizeClassGrowth> v;
+        v.PushBack('a');
+        assert(v.Capacity() == 16);
+        for (int i = 0; i < 16; ++i) {
+            v.PushBack('b');
+        }
+        assert(v.Capacity() == 24);
+    }
+}
+
+void Test11() {
+    const size_t INLINE_SIZE = 4;
+    const int ID = 42;
+    using Alloc = TrackingAllocator<Obj, true>;
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, INLINE_SIZE, Alloc> v;
+        for (size_t i = 0; i < INLINE_SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        assert(v.IsInline());
+        assert(v.Capacity() == INLINE_SIZE);
+        assert(Alloc::allocated_bytes[0] == 0);
+
+        v.Insert(v.cbegin() + 1, Obj{ID});
+        assert(!v.IsInline());
+        assert(v.Size() == INLINE_SIZE + 1);
+        assert(v.Capacity() == INLINE_SIZE * 2);
+        assert(Alloc::allocated_bytes[0] == INLINE_SIZE * 2 * sizeof(Obj));
+        assert(v[0].id == 0);
+        assert(v[1].id == ID);
+        assert(v[2].id == 1);
+
+        v.Erase(v.cbegin());
+        assert(v[0].id == ID);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(INLINE_SIZE));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    assert(Alloc::allocated_bytes[0] == 0);
+    {
+        SmallVector<Obj, INLINE_SIZE> small(INLINE_SIZE - 1);
+        small[0].id = ID;
+        SmallVector<Obj, INLINE_SIZE> large(INLINE_SIZE * 3);
+        large[INLINE_SIZE].id = ID;
+
+        SmallVector<Obj, INLINE_SIZE> small_copy(small);
+        assert(small_copy.IsInline());
+        assert(small_copy[0].id == ID);
+
+        SmallVector<Obj, INLINE_SIZE> moved(std::move(small));
+        assert(moved.IsInline());
+        assert(moved.Size() == INLINE_SIZE - 1);
+        assert(moved[0].id == ID);
+        assert(small.Size() == 0);
+
+        const Obj* large_data = &large[0];
+        SmallVector<Obj, INLINE_SIZE> moved_large(std::move(large));
+        assert(&moved_large[0] == large_data);
+
+        moved.Swap(moved_large);
+        assert(moved.Size() == INLINE_SIZE * 3);
+        assert(moved[INLINE_SIZE].id == ID);
+        assert(moved_large.Size() == INLINE_SIZE - 1);
+        assert(moved_large[0].id == ID);
+
+        moved_large = moved;
+        assert(moved_large.Size() == INLINE_SIZE * 3);
+        assert(moved_large[INLINE_SIZE].id == ID);
+
+        moved_large.Resize(1);
+        moved_large = std::move(small_copy);
+        assert(moved_large.Size() == INLINE_SIZE - 1);
+        assert(moved_large[0].id == ID);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<Obj, INLINE_SIZE> v(INLINE_SIZE);
+        v[INLINE_SIZE - 1].throw_on_copy = true;
+        Obj::ResetCounters();
+        // Obj перемещается без исключений, поэтому копирования при переполнении не будет
+        v.EmplaceBack(ID);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_moved == static_cast<int>(INLINE_SIZE));
+    }
+    {
+        // Аллокатор, не распространяющийся при присваивании: чужая память не забирается
+        using StickyAlloc = TrackingAllocator<Obj, false>;
+        Obj::ResetCounters();
+        SmallVector<Obj, INLINE_SIZE, StickyAlloc> first(StickyAlloc{1});
+        SmallVector<Obj, INLINE_SIZE, StickyAlloc> second(StickyAlloc{2});
+        for (size_t i = 0; i < INLINE_SIZE * 2; ++i) {
+            second.EmplaceBack(static_cast<int>(i));
+        }
+        first = std::move(second);
+        assert(first.GetAllocator().id == 1 && first.Size() == INLINE_SIZE * 2 && first[INLINE_SIZE].id == 4);
+        assert(StickyAlloc::allocated_bytes[1] == INLINE_SIZE * 2 * sizeof(Obj));
+        second = first;
+        assert(second.GetAllocator().id == 2 && second[1].id == 1);
+
+        // Распространяющийся аллокатор переходит вместе с содержимым, даже встроенным
+        using PropagatingAlloc = TrackingAllocator<Obj, true>;
+        SmallVector<Obj, INLINE_SIZE, PropagatingAlloc> third(PropagatingAlloc{1});
+        SmallVector<Obj, INLINE_SIZE, PropagatingAlloc> fourth(PropagatingAlloc{2});
+        fourth.EmplaceBack(ID);
+        third.Swap(fourth);
+        assert(third.GetAllocator().id == 2 && third.IsInline() && third[0].id == ID);
+        assert(fourth.GetAllocator().id == 1 && fourth.Size() == 0);
+        fourth = std::move(third);
+        assert(fourth.GetAllocator().id == 2 && fourth[0].id == ID);
+        SmallVector<Obj, INLINE_SIZE, PropagatingAlloc> fifth(PropagatingAlloc{1});
+        fifth = fourth;
+        assert(fifth.GetAllocator().id == 2 && fifth[0].id == ID);
+    }
+    assert((TrackingAllocator<Obj, false>::allocated_bytes[1] == 0));
+    assert((TrackingAllocator<Obj, false>::allocated_bytes[2] == 0));
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SmallVector<TestObj, INLINE_SIZE> v(INLINE_SIZE);
+        v.PushBack(v[0]);
+        v.Insert(v.cbegin() + 1, v[0]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+        }));
+    }
+}
+
+namespace {
+
+struct alignas(128) OverAligned {
+    int value = 0;
+};
+
+bool IsAligned(const void* p, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+}  // namespace
+
+void Test12() {
+    const size_t SIZE = 1000;
+    {
+        AlignedVector<float> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(IsAligned(v.begin(), CACHE_LINE_SIZE));
+        }
+        AlignedVector<float> v_copy(v);
+        assert(IsAligned(v_copy.begin(), CACHE_LINE_SIZE));
+        assert(v_copy[SIZE - 1] == static_cast<float>(SIZE - 1));
+    }
+    {
+        AlignedVector<char, 4096> v(SIZE);
+        assert(IsAligned(v.begin(), 4096));
+        using Rebound = std::allocator_traits<AlignedAllocator<char, 4096>>::rebind_alloc<int>;
+        static_assert(std::is_same_v<Rebound, AlignedAllocator<int, 4096>>);
+    }
+    {
+        static_assert(AlignedAllocator<OverAligned, 16>::ALIGNMENT == alignof(OverAligned));
+        Vector<OverAligned> v(SIZE);
+        assert(IsAligned(v.begin(), alignof(OverAligned)));
+        AlignedVector<OverAligned, 16> v_aligned(SIZE);
+        assert(IsAligned(v_aligned.begin(), alignof(OverAligned)));
+    }
+}
+
+void Test13() {
+    const size_t SMALL_SIZE = 100;
+    using Alloc = HugePageAllocator<int, HUGE_PAGE_SIZE>;
+    {
+        Vector<int, Alloc> v(SMALL_SIZE);
+        assert(!Alloc::IsHuge(v.Capacity()));
+        v[SMALL_SIZE - 1] = 1;
+        v.Reserve(HUGE_PAGE_SIZE / sizeof(int) + 1);
+        assert(Alloc::IsHuge(v.Capacity()));
+        assert(IsAligned(v.begin(), HUGE_PAGE_SIZE));
+        assert(v[SMALL_SIZE - 1] == 1);
+        v.Resize(v.Capacity());
+        v[v.Size() - 1] = 2;
+        v.PushBack(3);
+        assert(IsAligned(v.begin(), HUGE_PAGE_SIZE));
+        assert(v[SMALL_SIZE - 1] == 1);
+        assert(v[v.Size() - 2] == 2);
+        assert(v[v.Size() - 1] == 3);
+    }
+    {
+        // Без зарезервированного пула MAP_HUGETLB откатывается на обычные страницы
+        Vector<int, HugePageAllocator<int, HUGE_PAGE_SIZE, true>> v(HUGE_PAGE_SIZE);
+        assert(IsAligned(v.begin(), HUGE_PAGE_SIZE));
+        assert(v[HUGE_PAGE_SIZE - 1] == 0);
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 100'000;
+    const std::string path = "/tmp/no_std_vector_test_" + std::to_string(getpid()) + ".bin";
+    {
+        MappedVector<uint64_t> v(path);
+        assert(v.Size() == 0);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(i * i);
+        }
+        v.EmplaceBack(v[1]);
+        assert(v.Size() == SIZE + 1);
+        v.Flush();
+    }
+    {
+        MappedVector<uint64_t> v(path);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() >= v.Size());
+        assert(v[SIZE - 1] == (SIZE - 1) * (SIZE - 1));
+        assert(v[SIZE] == 1);
+        v.PopBack();
+        v.Resize(SIZE / 2);
+        MappedVector<uint64_t> moved(std::move(v));
+        assert(moved.Size() == SIZE / 2);
+    }
+    {
+        MappedVector<uint64_t> v(path);
+        assert(v.Size() == SIZE / 2);
+        assert(std::accumulate(v.begin(), v.end(), uint64_t{0}) == (SIZE / 2 - 1) * (SIZE / 2) * (SIZE - 1) / 6);
+    }
+    try {
+        MappedVector<uint32_t> v(path);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error&) {
+    }
+    std::remove(path.c_str());
+}
+
+void Test15() {
+    const size_t SIZE = 1000;
+    {
+        MonotonicArena arena(SIZE * 8 * sizeof(Obj));
+        ArenaAllocator<Obj> alloc(arena);
+        Obj::ResetCounters();
+        {
+            Vector<Obj, ArenaAllocator<Obj>> v(alloc);
+            v.EmplaceBack(0);
+            const Obj* data = v.begin();
+            for (size_t i = 1; i < SIZE; ++i) {
+                v.EmplaceBack(static_cast<int>(i));
+            }
+            // Вектор - последний блок арены, поэтому он рос без переноса элементов
+            assert(v.begin() == data);
+            assert(Obj::num_moved == 0);
+            assert(v[SIZE - 1].id == static_cast<int>(SIZE - 1));
+
+            v.Insert(v.cbegin(), Obj{-1});
+            assert(v[0].id == -1);
+            assert(v[SIZE].id == static_cast<int>(SIZE - 1));
+
+            Vector<Obj, ArenaAllocator<Obj>> other(SIZE, alloc);
+            const size_t old_capacity = v.Capacity();
+            const int old_num_moved = Obj::num_moved;
+            v.Reserve(old_capacity * 2);
+            // Следом выделен другой вектор, поэтому расширить на месте уже нельзя
+            assert(v.begin() != data);
+            assert(Obj::num_moved == old_num_moved + static_cast<int>(SIZE + 1));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+        assert(arena.ReservedBytes() > 0);
+        arena.Release();
+        assert(arena.ReservedBytes() == 0);
+    }
+    {
+        MonotonicArena arena(64);
+        ArenaAllocator<double> alloc(arena);
+        SmallVector<double, 2, ArenaAllocator<double>> v(alloc);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<double>(i));
+        }
+        assert(v[SIZE - 1] == static_cast<double>(SIZE - 1));
+        ArenaAllocator<char> char_alloc(alloc);
+        assert(char_alloc == alloc);
+    }
+    {
+        // Повторное использование арены после Release не раздувает размер кусков
+        MonotonicArena arena(256);
+        size_t first_cycle_bytes = 0U;
+        for (int cycle = 0; cycle < 20; ++cycle) {
+            {
+                Vector<int, ArenaAllocator<int>> v{ArenaAllocator<int>(arena)};
+                for (size_t i = 0; i < SIZE; ++i) {
+                    v.PushBack(static_cast<int>(i));
+                }
+            }
+            if (cycle == 0) {
+                first_cycle_bytes = arena.ReservedBytes();
+            }
+            assert(arena.ReservedBytes() == first_cycle_bytes);
+            arena.Release();
+        }
+    }
+}
+
+void Test16() {
+    const size_t SIZE = 1000;
+    const int ROUNDS = 10;
+    BufferPool& pool = BufferPool::Local();
+    pool.Trim();
+    pool.ResetStats();
+    // Каждый проход выделяет буфер на каждом шаге роста до SIZE элементов
+    size_t allocations_per_round = 0U;
+    for (size_t capacity = 0; capacity < SIZE; ++allocations_per_round) {
+        capacity = DoublingGrowth::NextCapacity(capacity, capacity + 1U, sizeof(int));
+    }
+    for (int round = 0; round < ROUNDS; ++round) {
+        Vector<int, PooledAllocator<int>> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        assert(v[SIZE - 1] == static_cast<int>(SIZE - 1));
+    }
+    // Первый проход прогревает пул, дальше все буферы берутся из него
+    const size_t warmup_misses = pool.Stats().misses;
+    assert(warmup_misses <= allocations_per_round);
+    assert(pool.Stats().hits + pool.Stats().misses == allocations_per_round * ROUNDS);
+    assert(pool.Stats().HitRate() > 0.85);
+    {
+        // Буферы разных типов одного класса размеров взаимозаменяемы
+        Vector<char, PooledAllocator<char>> v(SIZE * sizeof(int));
+        assert(pool.Stats().misses == warmup_misses);
+    }
+    pool.SetMaxCachedPerClass(0);
+    {
+        Vector<int, PooledAllocator<int>> v(SIZE);
+    }
+    assert(pool.Stats().released == 1);
+    pool.SetMaxCachedPerClass(BufferPool::DEFAULT_MAX_CACHED_PER_CLASS);
+    pool.Trim();
+
+    // Статический вектор освобождает память после уничтожения пула главного потока
+    static Vector<int, PooledAllocator<int>> outlives_pool(SIZE);
+    assert(BufferPool::LocalIfAlive() == &pool);
+}
+
+namespace {
+
+// Инструментирование, запоминающее все события
+struct RecordingInstrumentation {
+    static constexpr bool ENABLED = true;
+
+    static void OnEvent(const VectorEvent& event) noexcept {
+        if (num_events < events.size()) {
+            events[num_events] = event;
+        }
+        ++num_events;
+    }
+
+    inline static std::array<VectorEvent, 16> events{};
+    inline static size_t num_events = 0;
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
+using RecordedVector = Vector<T, Allocator, DoublingGrowth, RecordingInstrumentation>;
+
+}  // namespace
+
+void Test17() {
+    static_assert(sizeof(RecordedVector<int>) == sizeof(Vector<int>));
+    const auto& events = RecordingInstrumentation::events;
+    RecordingInstrumentation::num_events = 0;
+    const void* address = nullptr;
+    {
+        RecordedVector<int> v;
+        address = &v;
+        v.Reserve(4);
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(i);
+        }
+        v.Resize(20);
+        v.Reserve(10);
+        v.Resize(2);
+        v.Resize(20);
+        v.Insert(v.cbegin(), -1);
+        assert(RecordingInstrumentation::num_events == 4);
+    }
+    assert(RecordingInstrumentation::num_events == 5);
+    assert(events[0].kind == VectorEventKind::RESERVE);
+    assert(events[0].container == address);
+    assert(events[0].element_size == sizeof(int));
+    assert(events[0].old_capacity == 0 && events[0].new_capacity == 4);
+    assert(events[0].bytes_moved == 0);
+    assert(events[1].kind == VectorEventKind::GROW);
+    assert(events[1].old_capacity == 4 && events[1].new_capacity == 8);
+    assert(events[1].bytes_moved == 4 * sizeof(int));
+    assert(events[2].kind == VectorEventKind::RESIZE);
+    assert(events[2].old_capacity == 8 && events[2].new_capacity == 20);
+    assert(events[2].bytes_moved == 5 * sizeof(int));
+    assert(events[3].kind == VectorEventKind::GROW);
+    assert(events[3].old_capacity == 20 && events[3].new_capacity == 40);
+    assert(events[3].bytes_moved == 20 * sizeof(int));
+    assert(events[4].kind == VectorEventKind::DESTROY);
+    assert(events[4].old_capacity == 40 && events[4].new_capacity == 0);
+    for (size_t i = 0; i < 5; ++i) {
+        assert(events[i].elapsed.count() >= 0);
+    }
+
+    RecordingInstrumentation::num_events = 0;
+    {
+        // Рост на месте в арене ничего не переносит
+        MonotonicArena arena(4096);
+        RecordedVector<int, ArenaAllocator<int>> v{ArenaAllocator<int>(arena)};
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        const size_t num_growths = RecordingInstrumentation::num_events;
+        assert(num_growths > 1);
+        for (size_t i = 0; i < num_growths; ++i) {
+            assert(events[i].kind == VectorEventKind::GROW);
+            assert(events[i].bytes_moved == 0);
+        }
+    }
+    RecordingInstrumentation::num_events = 0;
+    {
+        // Рост через realloc засчитывается аллокатору, даже если буфер сменил адрес
+        RecordedVector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        const size_t num_growths = RecordingInstrumentation::num_events;
+        assert(num_growths > 1);
+        for (size_t i = 0; i < num_growths; ++i) {
+            assert(events[i].bytes_moved == 0);
+        }
+    }
+    {
+        // Пустой вектор уничтожается без события
+        RecordingInstrumentation::num_events = 0;
+        RecordedVector<int> v;
+    }
+    assert(RecordingInstrumentation::num_events == 0);
+}
+
+template <typename V>
+concept AcceptsCallSite = requires(V& v) {
+    v.PushBack(1, std::source_location::current());
+};
+
+void Test18() {
+    // Место вызова принимают только инструментированные векторы
+    static_assert(!AcceptsCallSite<Vector<int>>);
+    static_assert(AcceptsCallSite<ProfiledVector<int>>);
+    CallSiteProfiler& profiler = CallSiteProfiler::Instance();
+    profiler.SetReportAtExit(false);
+    profiler.Reset();
+    const size_t SIZE = 100;
+    uint_least32_t push_back_line = 0;
+    uint_least32_t emplace_back_line = 0;
+    {
+        ProfiledVector<int> reserved;
+        reserved.Reserve(SIZE);
+        ProfiledVector<int> grown;
+        for (size_t i = 0; i < SIZE; ++i) {
+            reserved.PushBack(static_cast<int>(i));
+            push_back_line = std::source_location::current().line() + 1;
+            grown.PushBack(static_cast<int>(i));
+        }
+        ProfiledVector<std::string> strings;
+        for (size_t i = 0; i < 3; ++i) {
+            emplace_back_line = std::source_location::current().line() + 1;
+            strings.EmplaceBack(CallSite{}, 10, 'x');
+            strings.EmplaceBack(5, 'y');
+        }
+        strings.EmplaceBack(1, 'w');
+        strings.EmplaceBack(1, 'w');
+        assert(strings.Size() == strings.Capacity());
+        strings.Insert(strings.cbegin(), "z");
+        assert(strings[0] == "z" && strings[1] == std::string(10, 'x') && strings[2] == "yyyyy");
+    }
+    const std::vector<CallSiteStats> stats = profiler.Sorted();
+    // Рост reserved не попадает в отчёт, EmplaceBack без CallSite не учитывается
+    assert(stats.size() == 3);
+    assert(stats[0].site.line() == push_back_line);
+    assert(std::string_view(stats[0].site.file_name()).ends_with("main.cpp"));
+    // 1 -> 2 -> 4 -> ... -> 128: восемь увеличений, в новый буфер переносилось 1 + 2 + ... + 64 элемента
+    assert(stats[0].growths == 8 && stats[0].reallocations == 7);
+    assert(stats[0].bytes_copied == 127 * sizeof(int));
+    const bool emplace_first = stats[1].site.line() == emplace_back_line;
+    const CallSiteStats& emplace_stats = emplace_first ? stats[1] : stats[2];
+    const CallSiteStats& insert_stats = emplace_first ? stats[2] : stats[1];
+    assert(emplace_stats.site.line() == emplace_back_line);
+    assert(emplace_stats.growths == 3 && emplace_stats.reallocations == 2);
+    assert(insert_stats.growths == 1 && insert_stats.bytes_copied == 8 * sizeof(std::string));
+
+    std::ostringstream report;
+    profiler.Report(report, 1);
+    assert(report.str().find("main.cpp:" + std::to_string(push_back_line)) != std::string::npos);
+    assert(report.str().find(std::to_string(127 * sizeof(int)) + " bytes copied") != std::string::npos);
+    profiler.Reset();
+}
+
+namespace {
+
+// Строит вектор в одном и том же месте и возвращает, сколько раз он менял буфер
+size_t BuildAdaptive(size_t size, size_t* initial_capacity = nullptr) {
+    AdaptiveVector<int> v;
+    if (initial_capacity != nullptr) {
+        *initial_capacity = v.Capacity();
+    }
+    size_t reallocations = 0;
+    const int* data = v.begin();
+    for (size_t i = 0; i < size; ++i) {
+        v.PushBack(static_cast<int>(i));
+        if (v.begin() != data) {
+            ++reallocations;
+            data = v.begin();
+        }
+    }
+    return reallocations;
+}
+
+}  // namespace
+
+void Test19() {
+    CapacityLearner& learner = CapacityLearner::Instance();
+    learner.Reset();
+    const size_t SIZE = 1000;
+    // Первый вектор растёт как обычно, следующие сразу получают нужную вместимость
+    assert(BuildAdaptive(SIZE) > 5);
+    assert(BuildAdaptive(SIZE) == 0);
+    assert(BuildAdaptive(SIZE - 10) == 0);
+    assert(BuildAdaptive(SIZE + 10) == 1);
+    assert(BuildAdaptive(SIZE + 10) == 0);
+    // После выброса выученная вместимость постепенно уменьшается
+    BuildAdaptive(100 * SIZE);
+    size_t previous = 100 * SIZE;
+    for (int i = 0; i < 30; ++i) {
+        size_t capacity = 0;
+        assert(BuildAdaptive(SIZE, &capacity) == 0);
+        assert(capacity >= SIZE && capacity <= previous);
+        previous = capacity;
+    }
+    assert(previous < 2 * SIZE);
+    {
+        AdaptiveVector<std::string> a;
+        a.PushBack("a");
+        AdaptiveVector<std::string> b(std::move(a));
+        AdaptiveVector<std::string> c;
+        c = b;
+        c = std::move(b);
+        assert(c.Size() == 1 && c[0] == "a");
+        c.Swap(b);
+        assert(c.Size() == 0 && b.Size() == 1 && b[0] == "a");
+    }
+    // Vector без виртуального деструктора не должен служить открытой базой
+    static_assert(!std::is_convertible_v<AdaptiveVector<int>*, Vector<int>*>);
+    learner.Reset();
+}
+
+void Test20() {
+    {
+        const std::vector<int> source{1, 2, 3, 4, 5};
+        Vector<int> v(source.begin(), source.end());
+        assert(v.Size() == 5 && v.Capacity() == 5);
+        assert(std::equal(v.begin(), v.end(), source.begin(), source.end()));
+
+        std::istringstream input("7 8 9");
+        Vector<int> from_stream{std::istream_iterator<int>(input), std::istream_iterator<int>()};
+        assert(from_stream.Size() == 3 && from_stream[2] == 9);
+
+        v.Insert(v.cbegin() + 2, from_stream.begin(), from_stream.end());
+        const std::vector<int> expected{1, 2, 7, 8, 9, 3, 4, 5};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+        std::istringstream more("10 11");
+        v.Insert(v.cbegin(), std::istream_iterator<int>(more), std::istream_iterator<int>());
+        assert(v.Size() == 10 && v[0] == 10 && v[1] == 11 && v[2] == 1);
+
+        // Значение - элемент самого вектора
+        v.Insert(v.cbegin() + 1, 3, v[0]);
+        assert(v.Size() == 13 && v[1] == 10 && v[3] == 10 && v[4] == 11);
+        assert(v.Insert(v.cend(), 0, 42) == v.end());
+
+        v.Append(std::views::iota(0, 4) | std::views::transform([](int i) {
+            return i * i;
+        }));
+        assert(v.Size() == 17 && v[16] == 9);
+    }
+    {
+        // Вставка растит вектор не более одного раза
+        RecordingInstrumentation::num_events = 0;
+        RecordedVector<int> v;
+        v.PushBack(0);
+        const std::vector<int> source(100, 1);
+        v.Insert(v.cbegin(), source.begin(), source.end());
+        v.Append(source);
+        assert(v.Size() == 201 && v[0] == 1 && v[100] == 0 && v[200] == 1);
+        assert(RecordingInstrumentation::num_events == 3);
+        assert(RecordingInstrumentation::events[1].bytes_moved == sizeof(int));
+    }
+    {
+        // Нетривиальный тип: вставка короче хвоста, длиннее хвоста и с ростом
+        Vector<std::string> v;
+        v.Reserve(16);
+        for (const char* s : {"a", "b", "c", "d"}) {
+            v.PushBack(s);
+        }
+        const std::vector<std::string> two{"x", "y"};
+        v.Insert(v.cbegin() + 1, two.begin(), two.end());
+        const std::vector<std::string> five{"1", "2", "3", "4", "5"};
+        v.Insert(v.cbegin() + 4, five.begin(), five.end());
+        const std::vector<std::string> expected{"a", "x", "y", "b", "1", "2", "3", "4", "5", "c", "d"};
+        assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+        v.Insert(v.cbegin(), 10, std::string("z"));
+        assert(v.Size() == 21 && v.Capacity() >= 21 && v[9] == "z" && v[10] == "a" && v[20] == "d");
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(4);
+        v.EmplaceBack(1);
+        v.EmplaceBack(2);
+        Vector<Obj> source;
+        source.EmplaceBack(3);
+        source.EmplaceBack(4);
+        source.EmplaceBack(5);
+        source[2].throw_on_copy = true;
+        // Исключение при копировании в новый буфер не трогает исходный вектор
+        try {
+            v.Insert(v.cbegin() + 1, source.begin(), source.end());
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2 && v.Capacity() == 4 && v[0].id == 1 && v[1].id == 2);
+        source[2].throw_on_copy = false;
+        v.Insert(v.cbegin() + 1, source.begin(), source.end());
+        assert(v.Size() == 5 && v[1].id == 3 && v[3].id == 5 && v[4].id == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test21() {
+    const int SIZE = 20;
+    {
+        Vector<int> v(std::views::iota(0, SIZE).begin(), std::views::iota(0, SIZE).end());
+        assert(v.Erase(v.cbegin() + 5, v.cbegin() + 5) == v.begin() + 5);
+        assert(v.Erase(v.cbegin() + 5, v.cbegin() + 10) == v.begin() + 5);
+        assert(v.Size() == SIZE - 5 && v[4] == 4 && v[5] == 10);
+        assert(v.EraseIf([](int i) {
+            return i % 2 == 0;
+        }) == 8);
+        const std::vector<int> odd{1, 3, 11, 13, 15, 17, 19};
+        assert(std::equal(v.begin(), v.end(), odd.begin(), odd.end()));
+        v.EraseIndices(std::vector<size_t>{0, 2, 6});
+        const std::vector<int> rest{3, 13, 15, 17};
+        assert(std::equal(v.begin(), v.end(), rest.begin(), rest.end()));
+        v.EraseIndices(std::vector<size_t>{});
+        assert(v.Size() == 4);
+        v.Erase(v.cbegin(), v.cend());
+        assert(v.Size() == 0);
+    }
+    {
+        Vector<std::string> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        v.Erase(v.cbegin() + 1, v.cbegin() + 3);
+        assert(v.Size() == SIZE - 2 && v[0] == "0" && v[1] == "3");
+        v.EraseIf([](const std::string& s) {
+            return s.size() == 1;
+        });
+        assert(v.Size() == 10 && v[0] == "10" && v[9] == "19");
+        v.EraseIndices(std::vector<int>{1, 2, 9});
+        const std::vector<std::string> rest{"10", "13", "14", "15", "16", "17", "18"};
+        assert(std::equal(v.begin(), v.end(), rest.begin(), rest.end()));
+    }
+    {
+        // Исключение из предиката оставляет вектор корректным
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.PushBack(std::make_unique<int>(i));
+        }
+        try {
+            v.EraseIf([](const std::unique_ptr<int>& p) {
+                if (*p == 10) {
+                    throw std::runtime_error("Oops");
+                }
+                return *p % 2 == 0;
+            });
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE - 5);
+        assert(*v[0] == 1 && *v[4] == 9 && *v[5] == 10 && *v[SIZE - 6] == SIZE - 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.EraseIndices(std::vector<size_t>{0, 1, SIZE - 1});
+        assert(v.Size() == SIZE - 3 && v[0].id == 2 && v[SIZE - 4].id == SIZE - 2);
+        assert(Obj::GetAliveObjectCount() == SIZE - 3);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+namespace {
+
+// Аллокатор, заполняющий выделенную память узнаваемым байтом
+template <typename T>
+struct PatternAllocator {
+    using value_type = T;
+
+    static constexpr unsigned char PATTERN = 0xAB;
+
+    PatternAllocator() noexcept = default;
+
+    template <typename U>
+    PatternAllocator(const PatternAllocator<U>& /*other*/) noexcept {  // NOLINT
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+
+    T* allocate(size_t n) {
+        void* p = operator new(n * sizeof(T));
+        std::memset(p, PATTERN, n * sizeof(T));
+        return static_cast<T*>(p);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        operator delete(p);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+
+    template <typename U>
+    bool operator==(const PatternAllocator<U>& /*other*/) const noexcept {
+        return true;
+    }
+};
+
+bool HasPattern(const void* p, size_t bytes) {
+    const std::vector<unsigned char> pattern(bytes, PatternAllocator<char>::PATTERN);
+    return std::memcmp(p, pattern.data(), bytes) == 0;
+}
+
+}  // namespace
+
+void Test22() {
+    const size_t SIZE = 1000;
+    {
+        Vector<int, PatternAllocator<int>> v(SIZE, DEFAULT_INIT);
+        assert(v.Size() == SIZE);
+        // Память не обнулялась
+        assert(HasPattern(v.begin(), SIZE * sizeof(int)));
+        v.ResizeDefaultInit(SIZE * 3);
+        assert(HasPattern(v.begin() + SIZE, SIZE * 2 * sizeof(int)));
+        v.ResizeDefaultInit(SIZE);
+        assert(v.Size() == SIZE);
+        v.Resize(SIZE * 2);
+        assert(v[SIZE] == 0 && v[SIZE * 2 - 1] == 0);
+    }
+    {
+        Vector<std::string> v(3, DEFAULT_INIT);
+        v.ResizeDefaultInit(5);
+        assert(v.Size() == 5 && v[0].empty() && v[4].empty());
+        v.ResizeDefaultInit(1);
+        assert(v.Size() == 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, DEFAULT_INIT);
+        assert(Obj::num_default_constructed == static_cast<int>(SIZE));
+        Obj::default_construction_throw_countdown = 3;
+        try {
+            v.ResizeDefaultInit(SIZE * 2);
+            assert(false);
+        } catch (const std::runtime_error&) {
         }
-        return *this;
+        assert(v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+namespace {
+
+// Аллокатор, отдающий грязную память через allocate и чистую через allocate_zeroed
+template <typename T>
+struct ZeroingPatternAllocator : PatternAllocator<T> {
+    ZeroingPatternAllocator() noexcept = default;
+
+    template <typename U>
+    ZeroingPatternAllocator(const ZeroingPatternAllocator<U>& /*other*/) noexcept {  // NOLINT
+    }
+
+    T* allocate_zeroed(size_t n) {
+        ++num_zeroed;
+        void* p = operator new(n * sizeof(T));
+        std::memset(p, 0, n * sizeof(T));
+        return static_cast<T*>(p);
+    }
+
+    inline static size_t num_zeroed = 0;
+};
+
+struct ZeroPod {
+    int id;
+    double weight;
+};
+
+}  // namespace
+
+template <>
+struct IsZeroInitializable<ZeroPod> : std::true_type {};
+
+void Test23() {
+    static_assert(IS_ZERO_INITIALIZABLE<int> && IS_ZERO_INITIALIZABLE<double*> && IS_ZERO_INITIALIZABLE<ZeroPod>);
+    static_assert(!IS_ZERO_INITIALIZABLE<int ZeroPod::*> && !IS_ZERO_INITIALIZABLE<std::string>);
+    static_assert(RawMemory<int, MallocAllocator<int>>::CAN_ALLOCATE_ZEROED);
+    static_assert(!RawMemory<int>::CAN_ALLOCATE_ZEROED);
+
+    const size_t SIZE = 1000;
+    ZeroingPatternAllocator<int>::num_zeroed = 0;
+    {
+        Vector<int, ZeroingPatternAllocator<int>> v(SIZE);
+        assert(ZeroingPatternAllocator<int>::num_zeroed == 1U);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(std::all_of(v.begin(), v.end(), [](int x) { return x == 0; }));
+
+        // Внутри вместимости память грязная, новые элементы обнуляются явно
+        std::fill(v.begin(), v.end(), 7);
+        v.Resize(10);
+        v.Resize(SIZE);
+        assert(ZeroingPatternAllocator<int>::num_zeroed == 1U);
+        assert(v[9] == 7 && v[10] == 0 && v[SIZE - 1] == 0);
+
+        // Новых элементов больше, чем старых: берётся чистая память
+        v.Resize(SIZE * 3);
+        assert(ZeroingPatternAllocator<int>::num_zeroed == 2U);
+        assert(v[0] == 7 && v[9] == 7 && v[10] == 0 && v[SIZE * 3 - 1] == 0);
+
+        // Старых элементов больше: вектор растёт как обычно
+        v.Resize(SIZE * 4);
+        assert(ZeroingPatternAllocator<int>::num_zeroed == 2U);
+        assert(v[9] == 7 && v[SIZE * 4 - 1] == 0);
+    }
+    {
+        Vector<ZeroPod, ZeroingPatternAllocator<ZeroPod>> v(3);
+        assert(ZeroingPatternAllocator<ZeroPod>::num_zeroed == 1U);
+        assert(v[2].id == 0 && v[2].weight == 0.0);
+    }
+    {
+        // Крупный блок отображается через mmap и не трогается, пока к нему не обратились
+        const size_t LARGE_SIZE = size_t{1} << 24U;
+        Vector<int, MallocAllocator<int>> v(LARGE_SIZE);
+        assert(v[0] == 0 && v[LARGE_SIZE / 2] == 0 && v[LARGE_SIZE - 1] == 0);
+        v.Resize(LARGE_SIZE * 2);
+        assert(v[LARGE_SIZE * 2 - 1] == 0);
+        Vector<int, MallocAllocator<int>> small(SIZE);
+        assert(small[SIZE - 1] == 0);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
+    {
+        RecordingInstrumentation::num_events = 0;
+        RecordedVector<int, ZeroingPatternAllocator<int>> v;
+        v.PushBack(1);
+        v.Resize(SIZE);
+        assert(RecordingInstrumentation::num_events == 2U);
+        const VectorEvent& event = RecordingInstrumentation::events[1];
+        assert(event.kind == VectorEventKind::RESIZE && event.old_capacity == 1U && event.new_capacity == SIZE);
+        assert(event.bytes_moved == sizeof(int));
+        assert(v[0] == 1 && v[1] == 0);
+    }
+}
+
+void Test24() {
+    {
+        Vector<int> v;
+        v.Reserve(100);
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        v.ShrinkToFit();
+        assert(v.Size() == 10U && v.Capacity() == 10U);
+        assert(v[0] == 0 && v[9] == 9);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10U);
+        v.Clear();
+        assert(v.Size() == 0U && v.Capacity() == 10U);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0U && v.begin() == nullptr);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(1000);
+        v.Resize(3);
+        v[2] = 42;
+        v.ShrinkToFit();
+        assert(v.Capacity() == 3U && v[2] == 42);
+    }
+    {
+        const std::string long_string(100, 'a');
+        Vector<std::string> v;
+        v.Reserve(8);
+        v.PushBack(long_string);
+        v.PushBack("b");
+        v.ShrinkToFit();
+        assert(v.Capacity() == 2U && v[0] == long_string && v[1] == "b");
+    }
+    {
+        // Прежние элементы уничтожаются при перемещающем присваивании, а не переходят в источник
+        Obj::ResetCounters();
+        Vector<Obj> dst(5);
+        Vector<Obj> src(2);
+        dst = std::move(src);
+        assert(Obj::GetAliveObjectCount() == 2);
+        assert(dst.Size() == 2U && src.Size() == 0U && src.Capacity() == 0U);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        RecordingInstrumentation::num_events = 0;
+        RecordedVector<int> v;
+        v.Reserve(8);
+        v.PushBack(1);
+        v.ShrinkToFit();
+        assert(RecordingInstrumentation::num_events == 2U);
+        const VectorEvent& event = RecordingInstrumentation::events[1];
+        assert(event.kind == VectorEventKind::SHRINK && event.old_capacity == 8U && event.new_capacity == 1U);
+    }
+    {
+        static_assert(ShrinkingGrowthPolicy<HysteresisShrink<>> && !ShrinkingGrowthPolicy<DoublingGrowth>);
+        Vector<int, std::allocator<int>, HysteresisShrink<>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 1024U);
+        while (v.Size() > 256U) {
+            v.PopBack();
+        }
+        assert(v.Capacity() == 1024U);
+        v.PopBack();
+        assert(v.Size() == 255U && v.Capacity() == 510U);
+        assert(v[0] == 0 && v[254] == 254);
+
+        // Рост и удаление около порога не перевыделяют память
+        v.PushBack(255);
+        v.PopBack();
+        assert(v.Capacity() == 510U);
+
+        const auto it = v.Erase(v.begin() + 10, v.begin() + 250);
+        assert(v.Size() == 15U && v.Capacity() == 30U && *it == 250);
+        assert(v.EraseIf([](int x) { return x % 2 == 0; }) == 8U);
+        assert(v.Size() == 7U && v.Capacity() == 30U);
+        v.Erase(v.begin());
+        assert(v.Capacity() == 16U);
+        v.Resize(3);
+        assert(v.Capacity() == 16U);
+        assert(v[0] == 3 && v[1] == 5 && v[2] == 7);
+        v.Clear();
+        assert(v.Capacity() == 16U);
+    }
+    {
+        // Долгоживущий кэш после всплеска отдаёт память
+        Obj::ResetCounters();
+        Vector<Obj, std::allocator<Obj>, HysteresisShrink<OneAndHalfGrowth, 8U, 4U>> cache(1000);
+        cache.EraseIndices(std::views::iota(size_t{10}, size_t{1000}));
+        assert(cache.Size() == 10U && cache.Capacity() == 20U);
+        assert(Obj::GetAliveObjectCount() == 10);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+namespace {
+
+// Поле, перемещение которого может бросить исключение: при росте его столбец копируется,
+// а копирующее присваивание бросает по тому же счётчику
+struct ThrowingMoveField {
+    ThrowingMoveField() = default;
+    explicit ThrowingMoveField(int value)
+        : value(value)
+    {
+    }
+    ThrowingMoveField(const ThrowingMoveField& other)
+        : value(other.value)
+    {
+        if (--copy_throw_countdown == 0) {
+            throw std::runtime_error("Oops");
+        }
+    }
+    ThrowingMoveField(ThrowingMoveField&& other) noexcept(false)
+        : value(other.value)
+    {
+    }
+    ThrowingMoveField& operator=(const ThrowingMoveField& other) {
+        if (--copy_throw_countdown == 0) {
+            throw std::runtime_error("Oops");
+        }
+        value = other.value;
         return *this;
     }
-    ~C() {
-        ++dtor;
+
+    int value = 0;
+
+    static inline int copy_throw_countdown = 0;
+};
+
+}  // namespace
+
+void Test25() {
+    {
+        SoAVector<int, double, std::string> v;
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i, i * 0.5, std::to_string(i));
+        }
+        assert(v.Size() == 10U && v.Capacity() == 16U);
+
+        auto [id, weight, name] = v[3];
+        assert(id == 3 && weight == 1.5 && name == "3");
+        weight = 10.0;
+        assert(std::get<1>(v[3]) == 10.0);
+        v[4] = std::make_tuple(40, 4.0, std::string("forty"));
+        assert(std::get<0>(v[4]) == 40 && std::get<2>(v[4]) == "forty");
+
+        const std::span<const double> weights = std::as_const(v).Column<1>();
+        assert(weights.size() == 10U && &weights[1] == &weights[0] + 1);
+        double total = 0.0;
+        for (const double w : weights) {
+            total += w;
+        }
+        assert(total == 22.5 - 1.5 + 10.0 - 2.0 + 4.0);
+
+        const auto it = v.Erase(v.begin() + 1, v.begin() + 3);
+        assert(v.Size() == 8U && std::get<0>(*it) == 3);
+        v.Erase(v.cbegin());
+        assert(std::get<2>(v[0]) == "3");
+        v.PopBack();
+        assert(v.Size() == 6U && std::get<0>(v[5]) == 8);
+
+        int sum = 0;
+        for (auto [record_id, record_weight, record_name] : v) {
+            sum += record_id;
+            record_name += "!";
+        }
+        assert(sum == 3 + 40 + 5 + 6 + 7 + 8 && std::get<2>(v[1]) == "forty!");
+
+        SoAVector<int, double, std::string> copy(v);
+        v.Clear();
+        assert(v.Size() == 0U && copy.Size() == 6U && std::get<2>(copy[5]) == "8!");
+        v = std::move(copy);
+        assert(v.Size() == 6U && copy.Size() == 0U);
+    }
+    {
+        // Аргументы ссылаются на поля самого вектора, и вектор при этом растёт
+        SoAVector<std::string, int> v;
+        v.EmplaceBack(std::string(100, 'a'), 1);
+        assert(v.Capacity() == 1U);
+        v.EmplaceBack(std::get<0>(v[0]), std::get<1>(v[0]));
+        assert(std::get<0>(v[1]) == std::string(100, 'a') && std::get<1>(v[1]) == 1);
+        v.Resize(5);
+        assert(v.Size() == 5U && std::get<0>(v[4]).empty() && std::get<1>(v[4]) == 0);
+        v.Reserve(100);
+        assert(v.Capacity() == 100U && std::get<0>(v[0]) == std::string(100, 'a'));
+    }
+    {
+        // Исключение при конструировании поля откатывает уже сконструированные поля
+        Obj::ResetCounters();
+        SoAVector<Obj, Obj> v(2);
+        Obj throwing;
+        throwing.throw_on_copy = true;
+        try {
+            v.EmplaceBack(1, throwing);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 2U && Obj::GetAliveObjectCount() == 5);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Исключение при копировании столбца во время роста оставляет вектор нетронутым
+        SoAVector<std::unique_ptr<int>, ThrowingMoveField> v;
+        v.EmplaceBack(std::make_unique<int>(1), ThrowingMoveField{10});
+        v.EmplaceBack(std::make_unique<int>(2), ThrowingMoveField{20});
+        ThrowingMoveField::copy_throw_countdown = 2;
+        try {
+            v.Reserve(10);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == 2U && *std::get<0>(v[1]) == 2 && std::get<1>(v[1]).value == 20);
+        ThrowingMoveField::copy_throw_countdown = 0;
+        v.Reserve(10);
+        assert(v.Capacity() == 10U && *std::get<0>(v[0]) == 1 && std::get<1>(v[1]).value == 20);
+    }
+    {
+        // Исключение при сдвиге второго столбца не уничтожает хвост первого
+        SoAVector<Obj, ThrowingMoveField> v;
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i, ThrowingMoveField{i});
+        }
+        ThrowingMoveField::copy_throw_countdown = 2;
+        try {
+            v.Erase(v.begin(), v.begin() + 1);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 4U && Obj::GetAliveObjectCount() == 4);
+        ThrowingMoveField::copy_throw_countdown = 0;
+        v.Erase(v.begin(), v.begin() + 2);
+        assert(v.Size() == 2U && Obj::GetAliveObjectCount() == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+namespace {
+
+// Потокобезопасный аллокатор, считающий выделения
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() noexcept = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept  // NOLINT
+    {
+    }
+
+    T* allocate(size_t n) {
+        ++allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        std::allocator<T>().deallocate(p, n);
     }
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& /*other*/) const noexcept {
+        return true;
     }
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
+    static inline std::atomic<size_t> allocations = 0;
 };
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+}  // namespace
+
+void Test26() {
+    const size_t NUM_THREADS = 8;
+    const size_t PER_THREAD = 20'000;
+    {
+        ConcurrentVector<std::string, std::allocator<std::string>, 16U> v;
+        std::atomic<bool> done = false;
+        std::atomic<size_t> bad_reads = 0;
+        // Читатель обходит вектор одновременно с писателями и видит только целые элементы
+        std::thread reader([&] {
+            while (!done.load()) {
+                v.ForEach([&](size_t /*index*/, const std::string& value) {
+                    if (value.size() != 40U) {
+                        ++bad_reads;
+                    }
+                });
+            }
+        });
+        std::vector<std::thread> writers;
+        for (size_t t = 0; t < NUM_THREADS; ++t) {
+            writers.emplace_back([&v, t] {
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    std::string& value = v.EmplaceBack(40U, static_cast<char>('a' + t));
+                    assert(value[0] == static_cast<char>('a' + t));
+                }
+            });
+        }
+        for (std::thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+        assert(bad_reads == 0U);
+        assert(v.Size() == NUM_THREADS * PER_THREAD);
+
+        std::vector<size_t> per_thread(NUM_THREADS);
+        size_t visited = 0;
+        v.ForEach([&](size_t index, const std::string& value) {
+            assert(index == visited && v.IsReady(index) && &v[index] == &value);
+            ++per_thread[value[0] - 'a'];
+            ++visited;
+        });
+        assert(visited == NUM_THREADS * PER_THREAD);
+        assert(std::all_of(per_thread.begin(), per_thread.end(), [&](size_t n) { return n == PER_THREAD; }));
+    }
+    {
+        // Каждый сегмент выделяется ровно один раз, даже когда в него одновременно попадают все потоки
+        using Counting = ConcurrentVector<int, CountingAllocator<int>, 1U>;
+        for (int round = 0; round < 20; ++round) {
+            CountingAllocator<int>::allocations = 0U;
+            Counting v;
+            std::atomic<bool> start = false;
+            std::vector<std::thread> writers;
+            for (size_t t = 0; t < NUM_THREADS; ++t) {
+                writers.emplace_back([&v, &start] {
+                    while (!start.load()) {
+                    }
+                    for (int i = 0; i < 1000; ++i) {
+                        v.EmplaceBack(i);
+                    }
+                });
+            }
+            start = true;
+            for (std::thread& writer : writers) {
+                writer.join();
+            }
+            const size_t segments = Counting::Layout::Locate(v.Size() - 1U).segment + 1U;
+            assert(CountingAllocator<int>::allocations == segments);
+        }
+    }
+    {
+        // Рост не перемещает элементы
+        ConcurrentVector<int, std::allocator<int>, 4U> v;
+        const int* first = &v.EmplaceBack(1);
+        for (int i = 2; i <= 1000; ++i) {
+            v.PushBack(i);
+        }
+        assert(&v[0] == first && v[0] == 1 && v[4] == 5 && v[999] == 1000);
+        v.Clear();
+        assert(v.Size() == 0U && !v.IsReady(0));
+        v.Reserve(100);
+        assert(v.EmplaceBack(7) == 7);
+    }
+    {
+        // Исключение при конструировании оставляет пустую ячейку
+        Obj::ResetCounters();
+        {
+            ConcurrentVector<Obj> v;
+            v.EmplaceBack(1);
+            Obj::default_construction_throw_countdown = 1;
+            try {
+                v.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            v.EmplaceBack(3);
+            assert(v.Size() == 3U && !v.IsReady(1) && v[2].id == 3);
+            size_t visited = 0;
+            v.ForEach([&visited](size_t /*index*/, const Obj& /*obj*/) {
+                ++visited;
+            });
+            assert(visited == 2U);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
+void Test27() {
+    using Segmented = SegmentedVector<int, std::allocator<int>, 4U>;
+    static_assert(std::random_access_iterator<Segmented::iterator>);
+    static_assert(std::random_access_iterator<Segmented::const_iterator>);
+    {
+        // Рост не перемещает элементы, индексы верны на границах сегментов
+        Segmented v;
+        const int* first = &v.EmplaceBack(0);
+        std::vector<const int*> addresses{first};
+        for (int i = 1; i < 1000; ++i) {
+            addresses.push_back(&v.EmplaceBack(i));
+        }
+        assert(v.Size() == 1000U && v.Capacity() >= 1000U && v.Capacity() < 2000U);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i) && &v[i] == addresses[i]);
+        }
+        assert(&v[0] == first);
+        assert(std::accumulate(v.begin(), v.end(), 0) == 999 * 1000 / 2);
+        assert(v.end() - v.begin() == 1000 && *(v.begin() + 507) == 507 && v.begin()[60] == 60);
+        assert(*std::prev(v.end()) == 999 && *(v.end() - 4) == 996);
+
+        std::sort(v.begin(), v.end(), std::greater<>());
+        assert(v[0] == 999 && v[999] == 0 && std::is_sorted(v.cbegin(), v.cend(), std::greater<>()));
+
+        // Аргумент может ссылаться на элемент того же вектора
+        v.Resize(4);
+        v.PushBack(v[0]);
+        assert(v.Size() == 5U && v[4] == 999);
+
+        v.ShrinkToFit();
+        assert(v.Capacity() == 12U && &v[0] == first);
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.Size() == 0U && v.Capacity() == 0U && v.begin() == v.end());
+    }
+    {
+        // Копирование, перемещение, обмен
+        SegmentedVector<std::string, std::allocator<std::string>, 2U> v;
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        auto copy = v;
+        assert(copy.Size() == 20U && copy[19] == "19" && &copy[0] != &v[0]);
+        const std::string* moved_address = &v[7];
+        auto moved = std::move(v);
+        assert(moved.Size() == 20U && &moved[7] == moved_address && v.Size() == 0U);
+        v = copy;
+        copy.PopBack();
+        copy.Swap(v);
+        assert(v.Size() == 19U && copy.Size() == 20U && copy[19] == "19");
+        moved = std::move(copy);
+        assert(moved.Size() == 20U && moved[18] == "18");
+    }
+    {
+        // Строгая гарантия Resize, все объекты уничтожаются
+        Obj::ResetCounters();
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+            SegmentedVector<Obj, std::allocator<Obj>, 2U> v;
+            v.EmplaceBack(1);
+            v.EmplaceBack(2, "two");
+            Obj::default_construction_throw_countdown = 5;
+            try {
+                v.Resize(10);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2U && Obj::GetAliveObjectCount() == 2 && v[1].name == "two");
+            v.Resize(10);
+            assert(Obj::GetAliveObjectCount() == 10);
+            v.Resize(3);
+            assert(Obj::GetAliveObjectCount() == 3);
         }
-        Dump();
-    } catch (...) {
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
+    {
+        // Аллокатор без конструктора по умолчанию
+        MonotonicArena arena;
+        SegmentedVector<int, ArenaAllocator<int>> v{ArenaAllocator<int>(arena)};
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == 100U && v[99] == 99 && v.GetAllocator() == ArenaAllocator<int>(arena));
+        auto moved = std::move(v);
+        moved.ShrinkToFit();
+        assert(moved[50] == 50 && arena.ReservedBytes() >= 100 * sizeof(int));
+    }
+}
+
+void Test28() {
+    {
+        // Рост открывает страницы на месте: указатели не меняются
+        PinnedVector<uint64_t> v;
+        assert(v.Capacity() == 0U && v.Data() == nullptr);
+        v.PushBack(0U);
+        const uint64_t* data = v.Data();
+        const uint64_t* first = &v[0];
+        for (uint64_t i = 1; i < 1'000'000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Data() == data && &v[0] == first && v.Size() == 1'000'000U && v.Capacity() >= v.Size());
+        assert(std::accumulate(v.begin(), v.end(), uint64_t{0}) == uint64_t{999'999} * 1'000'000 / 2);
+
+        // Аргумент может ссылаться на элемент того же вектора
+        v.Resize(10);
+        v.PushBack(v[9]);
+        assert(v.Size() == 11U && v[10] == 9U);
+
+        const size_t capacity = v.Capacity();
+        v.ShrinkToFit();
+        assert(v.Capacity() < capacity && v.Capacity() >= v.Size() && v.Data() == data);
+        v.Clear();
+        v.PushBack(42U);
+        assert(v.Data() == data && v[0] == 42U);
+    }
+    {
+        // Наибольшая вместимость не превышается
+        PinnedVector<int> v(1000);
+        v.Reserve(1000);
+        assert(v.MaxCapacity() == 1000U && v.Capacity() == 1000U);
+        v.Resize(1000);
+        try {
+            v.PushBack(1);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            v.Reserve(1001);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == 1000U);
+    }
+    {
+        // Копирование, перемещение, обмен
+        PinnedVector<std::string> v(100);
+        for (int i = 0; i < 20; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        PinnedVector<std::string> copy = v;
+        assert(copy.Size() == 20U && copy.MaxCapacity() == 100U && copy[19] == "19" && copy.Data() != v.Data());
+        const std::string* data = v.Data();
+        PinnedVector<std::string> moved = std::move(v);
+        assert(moved.Data() == data && moved.Size() == 20U && v.Size() == 0U);
+        v = copy;
+        copy.PopBack();
+        copy.Swap(v);
+        assert(v.Size() == 19U && copy.Size() == 20U && copy[19] == "19");
+        moved = std::move(copy);
+        assert(moved.Size() == 20U && moved[18] == "18");
+    }
+    {
+        // Строгая гарантия Resize и EmplaceBack, все объекты уничтожаются
+        Obj::ResetCounters();
+        {
+            PinnedVector<Obj> v;
+            v.EmplaceBack(1);
+            v.EmplaceBack(2, "two");
+            Obj::default_construction_throw_countdown = 5;
+            try {
+                v.Resize(10);
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2U && Obj::GetAliveObjectCount() == 2 && v[1].name == "two");
+            Obj::default_construction_throw_countdown = 1;
+            try {
+                v.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 2U && Obj::GetAliveObjectCount() == 2);
+            v.Resize(10);
+            assert(Obj::GetAliveObjectCount() == 10);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+}
+
+void Test29() {
+    {
+        // Перенос идёт по MigrationStep элементов за операцию, старый буфер потом освобождается
+        IncrementalVector<int, std::allocator<int>, DoublingGrowth, 2U> v;
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Capacity() == 8U && !v.IsMigrating());
+        v.PushBack(8);
+        assert(v.Capacity() == 16U && v.IsMigrating());
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i));
+        }
+        // Аргумент может ссылаться на ещё не перенесённый элемент
+        v.PushBack(v[7]);
+        v.PushBack(v[6]);
+        assert(v.IsMigrating() && v[9] == 7 && v[10] == 6);
+        v.PushBack(11);
+        assert(!v.IsMigrating() && v.Size() == 12U);
+        for (int i = 0; i < 4; ++i) {
+            v.PopBack();
+        }
+        assert(v[7] == 7 && v.Size() == 8U);
+
+        // PopBack за границу перенесённых элементов заканчивает перенос
+        for (int i = 8; i < 17; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.IsMigrating());
+        while (v.Size() > 3U) {
+            v.PopBack();
+        }
+        assert(!v.IsMigrating() && v[0] == 0 && v[2] == 2);
+
+        // Непрерывный доступ заканчивает перенос
+        for (int i = 3; i < 40; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.IsMigrating());
+        std::sort(v.begin(), v.end(), std::greater<>());
+        assert(!v.IsMigrating() && v[0] == 39 && v[39] == 0);
+        v.Reserve(100);
+        assert(v.Capacity() == 100U && v[0] == 39);
+    }
+    {
+        // Копирование и перемещение во время переноса
+        IncrementalVector<std::string, std::allocator<std::string>, DoublingGrowth, 1U> v;
+        for (int i = 0; i < 17; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        assert(v.IsMigrating());
+        const auto copy = v;
+        assert(copy.Size() == 17U && copy[16] == "16" && copy[3] == "3");
+        auto moved = std::move(v);
+        assert(moved.IsMigrating() && moved[5] == "5" && v.Size() == 0U && !v.IsMigrating());
+        v = copy;
+        moved.Swap(v);
+        assert(moved.Size() == 17U && v[16] == "16");
+    }
+    {
+        // Строгая гарантия при исключении в конструкторе и при переносе копированием
+        Obj::ResetCounters();
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            IncrementalVector<Obj, std::allocator<Obj>, DoublingGrowth, 1U> v;
+            for (int i = 0; i < 4; ++i) {
+                v.EmplaceBack(i);
+            }
+            Obj::default_construction_throw_countdown = 1;
+            try {
+                v.EmplaceBack();
+                assert(false);
+            } catch (const std::runtime_error&) {
+            }
+            assert(v.Size() == 4U && v.Capacity() == 4U && !v.IsMigrating() && Obj::GetAliveObjectCount() == 4);
+            v.EmplaceBack(4);
+            assert(v.IsMigrating() && v[0].id == 0 && v[4].id == 4);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        IncrementalVector<ThrowingMoveField, std::allocator<ThrowingMoveField>, DoublingGrowth, 1U> v;
+        for (int i = 0; i < 5; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.IsMigrating());
+        ThrowingMoveField::copy_throw_countdown = 1;
+        try {
+            v.EmplaceBack(5);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 5U && v.IsMigrating() && v[1].value == 1 && v[4].value == 4);
+        v.FinishMigration();
+        assert(!v.IsMigrating() && v[3].value == 3);
+    }
+    {
+        // При росте в 1.5 раза перенос не успевает закончиться, а аргумент ссылается
+        // на ещё не перенесённый элемент старого буфера
+        IncrementalVector<std::string, std::allocator<std::string>, OneAndHalfGrowth, 1U> v;
+        size_t aliased_growths = 0;
+        for (int i = 0; v.Size() < 1000; ++i) {
+            if (v.Size() == v.Capacity() && v.IsMigrating()) {
+                const size_t index = v.Size() * 2 / 3 - 1;
+                const std::string expected = v[index];
+                v.PushBack(v[index]);
+                assert(v[v.Size() - 1] == expected && v[index] == expected);
+                ++aliased_growths;
+            } else {
+                v.PushBack(std::string(32, static_cast<char>('a' + i % 26)));
+            }
         }
-        Dump();
-    } catch (...) {
+        assert(aliased_growths > 5);
     }
 }
 
@@ -648,7 +2369,29 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/**
+ * @brief Аллокатор на основе malloc/realloc, умеющий расширять память без копирования.
+ * @details Небольшие блоки выделяются через malloc и расширяются через realloc. Блоки от
+ * LARGE_BLOCK_BYTES байт (на Linux) отображаются напрямую через mmap и расширяются через
+ * mremap, который переносит страницы в таблице страниц, не копируя данные. Поддерживает
+ * расширение RawMemory::Reallocate, которое Vector использует для тривиально релоцируемых типов,
+ * и выделение заполненной нулями памяти через calloc или mmap без лишнего memset.
+ * @tparam T Тип объекта, который будет размещаться в памяти.
+ */
+template <typename T>
+class MallocAllocator {
+public:
+    using value_type = T; //!< Тип объекта.
+    using is_always_equal = std::true_type; //!< Аллокатор не имеет состояния.
+
+    //! Размер блока в байтах, начиная с которого память отображается через mmap.
+    static constexpr size_t LARGE_BLOCK_BYTES = size_t{1} << 20U;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "MallocAllocator does not support over-aligned types");
+
+    MallocAllocator() noexcept = default;
+
+    //! Конструктор преобразования из аллокатора для другого типа.
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U> & /*other*/) noexcept {  // NOLINT
+    }
+
+    /**
+     * @brief Выделяет сырую память под указанное количество элементов.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     * @throw std::bad_alloc если память выделить не удалось.
+     */
+    T *allocate(size_t n);
+
+    /**
+     * @brief Выделяет заполненную нулями память под указанное количество элементов.
+     * @details Крупные блоки отображаются через mmap и уже обнулены ядром, небольшие
+     * выделяются через calloc.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     * @throw std::bad_alloc если память выделить не удалось.
+     */
+    T *allocate_zeroed(size_t n);
+
+    /**
+     * @brief Освобождает память, выделенную ранее при помощи allocate или reallocate.
+     * @param p Указатель на память.
+     * @param n Количество элементов, под которое выделялась память.
+     */
+    void deallocate(T *p, size_t n) noexcept;
+
+    /**
+     * @brief Изменяет размер блока памяти, по возможности без переноса.
+     * @details Содержимое блока сохраняется побайтово. Если блок переносится, то старый
+     * указатель становится недействительным. При ошибке исходный блок остаётся нетронутым.
+     * @param p Указатель на память, выделенную этим аллокатором.
+     * @param old_n Текущее количество элементов блока.
+     * @param new_n Новое количество элементов блока.
+     * @return указатель на начало блока нового размера.
+     * @throw std::bad_alloc если память выделить не удалось.
+     */
+    T *reallocate(T *p, size_t old_n, size_t new_n);
+
+    //! Все экземпляры взаимозаменяемы.
+    template <typename U>
+    bool operator==(const MallocAllocator<U> & /*other*/) const noexcept {
+        return true;
+    }
+
+private:
+    /**
+     * @brief Проверяет, отображается ли блок указанного размера через mmap.
+     * @param n Количество элементов.
+     * @return true, если блок отображается через mmap.
+     */
+    static bool IsLarge(size_t n) noexcept;
+};
+
+template <typename T>
+bool MallocAllocator<T>::IsLarge(const size_t n) noexcept {
+#if defined(__linux__)
+    return n * sizeof(T) >= LARGE_BLOCK_BYTES;
+#else
+    return false;
+#endif
+}
+
+template <typename T>
+T *MallocAllocator<T>::allocate(const size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+#if defined(__linux__)
+    if (IsLarge(n)) {
+        void *p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(p);
+    }
+#endif
+    void *p = std::malloc(n * sizeof(T));
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T *>(p);
+}
+
+template <typename T>
+T *MallocAllocator<T>::allocate_zeroed(const size_t n) {
+    if (n > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    if (IsLarge(n)) {
+        // Анонимное отображение уже заполнено нулями
+        return allocate(n);
+    }
+    void *p = std::calloc(n, sizeof(T));
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<T *>(p);
+}
+
+template <typename T>
+void MallocAllocator<T>::deallocate(T *const p, const size_t n) noexcept {
+#if defined(__linux__)
+    if (IsLarge(n)) {
+        munmap(p, n * sizeof(T));
+        return;
+    }
+#endif
+    std::free(p);
+}
+
+template <typename T>
+T *MallocAllocator<T>::reallocate(T *const p, const size_t old_n, const size_t new_n) {
+    if (new_n > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::bad_array_new_length();
+    }
+    if (IsLarge(old_n) == IsLarge(new_n)) {
+#if defined(__linux__)
+        if (IsLarge(new_n)) {
+            void *new_p = mremap(p, old_n * sizeof(T), new_n * sizeof(T), MREMAP_MAYMOVE);
+            if (new_p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T *>(new_p);
+        }
+#endif
+        void *new_p = std::realloc(p, new_n * sizeof(T));
+        if (new_p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(new_p);
+    }
+
+    // Блок переходит между malloc и mmap, поэтому переносим его вручную
+    T *new_p = allocate(new_n);
+    std::memcpy(static_cast<void *>(new_p), static_cast<const void *>(p),
+                std::min(old_n, new_n) * sizeof(T));
+    deallocate(p, old_n);
+    return new_p;
+}
@@ -0,0 +1,520 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Заголовок файла MappedVector.
+ * @details Занимает первую страницу файла, элементы начинаются сразу после неё.
+ */
+struct MappedVectorHeader {
+    static constexpr uint64_t MAGIC = 0x524F544345564D4EULL; //!< Сигнатура файла.
+    static constexpr size_t BYTES = 4096U; //!< Размер заголовка вместе с выравниванием.
+
+    uint64_t magic = MAGIC; //!< Сигнатура.
+    uint64_t element_size = 0U; //!< Размер элемента в байтах.
+    uint64_t size = 0U; //!< Количество элементов.
+};
+
+/**
+ * @brief Аллокатор, отображающий в память файл с заголовком MappedVectorHeader.
+ * @details Выделение n элементов означает отображение файла, увеличенного до заголовка
+ * и n элементов. Содержимое файла при этом сохраняется, поэтому повторное "выделение" той же
+ * вместимости открывает ранее записанные данные. Освобождение снимает отображение, не трогая
+ * файл. Рост выполняется через ftruncate и mremap. Файловым дескриптором владеет MappedVector.
+ * @tparam T Тривиально копируемый тип элемента.
+ */
+template <typename T>
+class MappedFileAllocator {
+public:
+    using value_type = T; //!< Тип объекта.
+    using propagate_on_container_move_assignment = std::true_type; //!< Файл переезжает с памятью.
+    using propagate_on_container_swap = std::true_type; //!< Файл переезжает с памятью.
+
+    /**
+     * @brief Конструирует аллокатор для открытого файла.
+     * @param fd Файловый дескриптор, открытый на чтение и запись.
+     */
+    explicit MappedFileAllocator(int fd) noexcept;
+
+    /**
+     * @brief Отображает файл с указанным количеством элементов.
+     * @param n Количество элементов.
+     * @return указатель на первый элемент.
+     * @throw std::system_error при ошибке ввода-вывода.
+     */
+    T *allocate(size_t n);
+
+    /**
+     * @brief Снимает отображение файла.
+     * @param p Указатель на первый элемент.
+     * @param n Количество элементов отображения.
+     */
+    void deallocate(T *p, size_t n) noexcept;
+
+    /**
+     * @brief Увеличивает или уменьшает файл и его отображение.
+     * @param p Указатель на первый элемент.
+     * @param old_n Текущее количество элементов.
+     * @param new_n Новое количество элементов.
+     * @return указатель на первый элемент нового отображения.
+     * @throw std::system_error при ошибке ввода-вывода, отображение при этом остаётся прежним.
+     */
+    T *reallocate(T *p, size_t old_n, size_t new_n);
+
+    /**
+     * @brief Получает заголовок файла по указателю на первый элемент.
+     * @param p Указатель на первый элемент.
+     * @return заголовок.
+     */
+    static MappedVectorHeader *Header(T *p) noexcept;
+
+    //! Аллокаторы равны, если отображают один и тот же файл.
+    bool operator==(const MappedFileAllocator &other) const noexcept {
+        return fd_ == other.fd_;
+    }
+
+private:
+    int fd_ = -1; //!< Файловый дескриптор.
+
+    /**
+     * @brief Размер файла для указанного количества элементов.
+     * @param n Количество элементов.
+     * @return размер в байтах.
+     */
+    static size_t FileBytes(size_t n) noexcept;
+
+    /**
+     * @brief Меняет размер файла.
+     * @param n Количество элементов.
+     */
+    void Truncate(size_t n) const;
+};
+
+/**
+ * @brief Вектор, хранящий элементы в файле, отображённом в память.
+ * @details Данные переживают процесс: при повторном открытии того же файла вектор сразу
+ * видит сохранённые элементы без какой-либо десериализации - открытие стоит O(1), страницы
+ * подгружаются ядром по мере обращения. Память управляется RawMemory с MappedFileAllocator,
+ * поэтому рост идёт через RawMemory::Reallocate, то есть ftruncate и mremap.
+ * Размер сохраняется в заголовке файла при каждом изменении.
+ * @tparam T Тривиально копируемый тип элемента.
+ * @tparam GrowthPolicy Стратегия роста вместимости.
+ */
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+class MappedVector {
+public:
+    using iterator = T *; //!< Итератор.
+    using const_iterator = const T *; //!< Константный итератор.
+
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable T");
+    static_assert(alignof(T) <= MappedVectorHeader::BYTES);
+
+    /**
+     * @brief Открывает вектор в указанном файле, создавая файл при необходимости.
+     * @param path Путь к файлу.
+     * @throw std::system_error при ошибке ввода-вывода.
+     * @throw std::runtime_error если файл не является файлом MappedVector с таким же типом.
+     */
+    explicit MappedVector(const std::string &path);
+
+    //! Запрет на копирование.
+    MappedVector(const MappedVector &) = delete;
+    //! Запрет на копирование.
+    MappedVector &operator=(const MappedVector &) = delete;
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @param other Объект для перемещения.
+     */
+    MappedVector(MappedVector &&other) noexcept;
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @param rhs Объект для перемещения.
+     * @return текущий объект.
+     */
+    MappedVector &operator=(MappedVector &&rhs) noexcept;
+
+    /**
+     * @brief Снимает отображение и закрывает файл. Данные остаются в файле.
+     */
+    ~MappedVector();
+
+    //! Получить итератор на начало вектора.
+    iterator begin() noexcept;
+    //! @overload MappedVector::begin()
+    const_iterator begin() const noexcept;
+    //! Получить итератор на конец вектора.
+    iterator end() noexcept;
+    //! @overload MappedVector::end()
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Резервирует место под указанное количество элементов.
+     * @param new_capacity Новая вместимость вектора.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Меняет размер вектора на указанный.
+     * @details Новые элементы инициализируются значением по умолчанию.
+     * @param new_size Новый размер вектора.
+     */
+    void Resize(size_t new_size);
+
+    /**
+     * @brief Вставить объект в конец вектора.
+     * @param value Объект для вставки.
+     */
+    void PushBack(const T &value);
+
+    /**
+     * @brief Конструирует и вставляет объект в конец вектора.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param args Аргументы для конструирования объекта.
+     * @return возвращает ссылку на сконструированный объект.
+     */
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Удаляет последний элемент.
+     */
+    void PopBack() noexcept;
+
+    /**
+     * @brief Синхронно сбрасывает изменения на диск.
+     * @throw std::system_error при ошибке ввода-вывода.
+     */
+    void Flush();
+
+    /**
+     * @brief Получает размер.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Получает вместимость.
+     * @return вместимость.
+     */
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /**
+     * @brief Получает доступ к элементу по индексу.
+     * @param index Индекс элемента.
+     * @return ссылку на элемент.
+     */
+    T &operator[](size_t index) noexcept;
+
+    //! @overload MappedVector::operator[](size_t index)
+    const T &operator[](size_t index) const noexcept;
+
+private:
+    int fd_ = -1; //!< Файловый дескриптор.
+    RawMemory<T, MappedFileAllocator<T>> data_; //!< Отображённая память под элементы.
+    size_t size_ = 0U; //!< Размер.
+
+    /**
+     * @brief Открывает файл.
+     * @param path Путь к файлу.
+     * @return файловый дескриптор.
+     */
+    static int Open(const std::string &path);
+
+    /**
+     * @brief Определяет вместимость по размеру файла и проверяет его заголовок.
+     * @param fd Файловый дескриптор.
+     * @return вместимость.
+     */
+    static size_t ReadCapacity(int fd);
+
+    /**
+     * @brief Устанавливает размер и сохраняет его в заголовке.
+     * @param new_size Новый размер.
+     */
+    void SetSize(size_t new_size) noexcept;
+
+    /**
+     * @brief Закрывает файл.
+     */
+    void Close() noexcept;
+};
+
+template <typename T>
+MappedFileAllocator<T>::MappedFileAllocator(const int fd) noexcept
+: fd_(fd) {
+}
+
+template <typename T>
+size_t MappedFileAllocator<T>::FileBytes(const size_t n) noexcept {
+    return MappedVectorHeader::BYTES + n * sizeof(T);
+}
+
+template <typename T>
+void MappedFileAllocator<T>::Truncate(const size_t n) const {
+    if (ftruncate(fd_, static_cast<off_t>(FileBytes(n))) != 0) {
+        throw std::system_error(errno, std::generic_category(), "ftruncate");
+    }
+}
+
+template <typename T>
+MappedVectorHeader *MappedFileAllocator<T>::Header(T *const p) noexcept {
+    return reinterpret_cast<MappedVectorHeader *>(reinterpret_cast<std::byte *>(p) - MappedVectorHeader::BYTES);
+}
+
+template <typename T>
+T *MappedFileAllocator<T>::allocate(const size_t n) {
+    struct stat st {};
+    if (fstat(fd_, &st) != 0) {
+        throw std::system_error(errno, std::generic_category(), "fstat");
+    }
+    const bool is_new = static_cast<size_t>(st.st_size) < MappedVectorHeader::BYTES;
+    if (static_cast<size_t>(st.st_size) != FileBytes(n)) {
+        Truncate(n);
+    }
+    void *base = mmap(nullptr, FileBytes(n), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    if (is_new) {
+        auto *header = new (base) MappedVectorHeader{};
+        header->element_size = sizeof(T);
+    }
+    return reinterpret_cast<T *>(static_cast<std::byte *>(base) + MappedVectorHeader::BYTES);
+}
+
+template <typename T>
+void MappedFileAllocator<T>::deallocate(T *const p, const size_t n) noexcept {
+    munmap(Header(p), FileBytes(n));
+}
+
+template <typename T>
+T *MappedFileAllocator<T>::reallocate(T *const p, const size_t old_n, const size_t new_n) {
+    if (new_n > old_n) {
+        Truncate(new_n);
+    }
+#if defined(__linux__)
+    void *base = mremap(Header(p), FileBytes(old_n), FileBytes(new_n), MREMAP_MAYMOVE);
+#else
+    void *base = mmap(nullptr, FileBytes(new_n), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base != MAP_FAILED) {
+        munmap(Header(p), FileBytes(old_n));
+    }
+#endif
+    if (base == MAP_FAILED) {
+        const int error = errno;
+        if (new_n > old_n) {
+            static_cast<void>(ftruncate(fd_, static_cast<off_t>(FileBytes(old_n))));
+        }
+        throw std::system_error(error, std::generic_category(), "mremap");
+    }
+    if (new_n < old_n) {
+        Truncate(new_n);
+    }
+    return reinterpret_cast<T *>(static_cast<std::byte *>(base) + MappedVectorHeader::BYTES);
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(const std::string &path)
+: fd_(Open(path))
+, data_(MappedFileAllocator<T>(fd_)) {
+    try {
+        const size_t capacity = ReadCapacity(fd_);
+        RawMemory<T, MappedFileAllocator<T>> data(capacity, data_.GetAllocator());
+        if (capacity != 0U) {
+            size_ = MappedFileAllocator<T>::Header(data.GetAddress())->size;
+        }
+        data_.Swap(data);
+    } catch (...) {
+        Close();
+        throw;
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(MappedVector &&other) noexcept
+: fd_(std::exchange(other.fd_, -1))
+, data_(std::move(other.data_))
+, size_(std::exchange(other.size_, 0U)) {
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy> &MappedVector<T, GrowthPolicy>::operator=(MappedVector &&rhs) noexcept {
+    if (this != &rhs) {
+        data_ = std::move(rhs.data_);
+        Close();
+        fd_ = std::exchange(rhs.fd_, -1);
+        size_ = std::exchange(rhs.size_, 0U);
+    }
+    return *this;
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::~MappedVector() {
+    // Отображение остаётся действительным и после закрытия файла, его снимет data_
+    Close();
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::begin() noexcept {
+    return data_.GetAddress();
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::begin() const noexcept {
+    return data_.GetAddress();
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::iterator MappedVector<T, GrowthPolicy>::end() noexcept {
+    return data_ + size_;
+}
+
+template <typename T, typename GrowthPolicy>
+typename MappedVector<T, GrowthPolicy>::const_iterator MappedVector<T, GrowthPolicy>::end() const noexcept {
+    return data_ + size_;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Reserve(const size_t new_capacity) {
+    if (new_capacity > data_.Capacity()) {
+        data_.Reallocate(new_capacity);
+        SetSize(size_);
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Resize(const size_t new_size) {
+    if (new_size > size_) {
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
+    }
+    SetSize(new_size);
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PushBack(const T &value) {
+    EmplaceBack(value);
+}
+
+template <typename T, typename GrowthPolicy>
+template <typename... Args>
+T &MappedVector<T, GrowthPolicy>::EmplaceBack(Args &&...args) {
+    // Аргументы могут ссылаться на элементы вектора, поэтому объект создаётся до роста
+    T value(std::forward<Args>(args)...);
+    if (size_ == data_.Capacity()) {
+        Reserve(GrowthPolicy::NextCapacity(data_.Capacity(), size_ + 1U, sizeof(T)));
+    }
+    new (data_ + size_) T(value);
+    SetSize(size_ + 1U);
+    return data_[size_ - 1U];
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::PopBack() noexcept {
+    assert(size_ != 0U);
+    SetSize(size_ - 1U);
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Flush() {
+    if (data_.GetAddress() == nullptr) {
+        return;
+    }
+    if (msync(MappedFileAllocator<T>::Header(data_.GetAddress()),
+              MappedVectorHeader::BYTES + data_.Capacity() * sizeof(T), MS_SYNC) != 0) {
+        throw std::system_error(errno, std::generic_category(), "msync");
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Size() const noexcept {
+    return size_;
+}
+
+template <typename T, typename GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::Capacity() const noexcept {
+    return data_.Capacity();
+}
+
+template <typename T, typename GrowthPolicy>
+const T &MappedVector<T, GrowthPolicy>::operator[](const size_t index) const noexcept {
+    return const_cast<MappedVector &>(*this)[index];
+}
+
+template <typename T, typename GrowthPolicy>
+T &MappedVector<T, GrowthPolicy>::operator[](const size_t index) noexcept {
+    assert(index < size_);
+    return data_[index];
+}
+
+template <typename T, typename GrowthPolicy>
+int MappedVector<T, GrowthPolicy>::Open(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    return fd;
+}
+
+template <typename T, typename GrowthPolicy>
+size_t MappedVector<T, GrowthPolicy>::ReadCapacity(const int fd) {
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        throw std::system_error(errno, std::generic_category(), "fstat");
+    }
+    const auto file_bytes = static_cast<size_t>(st.st_size);
+    if (file_bytes == 0U) {
+        return 0U;
+    }
+
+    MappedVectorHeader header;
+    if (file_bytes < MappedVectorHeader::BYTES
+        || pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+        || header.magic != MappedVectorHeader::MAGIC) {
+        throw std::runtime_error("MappedVector: not a vector file");
+    }
+    if (header.element_size != sizeof(T)) {
+        throw std::runtime_error("MappedVector: element size mismatch");
+    }
+    const size_t capacity = (file_bytes - MappedVectorHeader::BYTES) / sizeof(T);
+    if (header.size > capacity) {
+        throw std::runtime_error("MappedVector: corrupted header");
+    }
+    return capacity;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::SetSize(const size_t new_size) noexcept {
+    size_ = new_size;
+    if (data_.GetAddress() != nullptr) {
+        MappedFileAllocator<T>::Header(data_.GetAddress())->size = new_size;
+    }
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::Close() noexcept {
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Аппаратные и программные счётчики производительности текущего потока и его потомков.
+ * @details На Linux счётчики открываются через perf_event_open: такты, инструкции, промахи
+ * кэша, ошибки предсказания переходов и страничные отказы. Счётчики, которые ядро не даёт
+ * открыть (нет PMU в виртуальной машине, запрет в perf_event_paranoid, другая ОС),
+ * пропускаются, а остальные продолжают работать. Считается только код пользователя.
+ * Если счётчики мультиплексируются, значения масштабируются на долю времени, которую
+ * счётчик реально работал. Счётчики наследуются потоками, созданными после их открытия,
+ * поэтому в замер попадает и работа рабочих потоков; ядро прибавляет её к значению,
+ * когда поток завершается, так что потоки нужно дождаться до Read.
+ */
+class PerfCounters {
+public:
+    //! Количество поддерживаемых счётчиков.
+    static constexpr size_t NUM_COUNTERS = 5U;
+
+    /**
+     * @brief Открывает все доступные счётчики.
+     */
+    PerfCounters() noexcept;
+
+    //! Запрет на копирование.
+    PerfCounters(const PerfCounters &) = delete;
+    //! Запрет на копирование.
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    /**
+     * @brief Закрывает счётчики.
+     */
+    ~PerfCounters();
+
+    /**
+     * @brief Проверяет, открыт ли хотя бы один счётчик.
+     * @return true, если есть что измерять.
+     */
+    [[nodiscard]] bool Available() const noexcept;
+
+    /**
+     * @brief Обнуляет и запускает счётчики.
+     */
+    void Start() noexcept;
+
+    /**
+     * @brief Останавливает счётчики.
+     */
+    void Stop() noexcept;
+
+    /**
+     * @brief Читает значения открытых счётчиков с момента последнего Start.
+     * @return пары из имени счётчика и его значения.
+     */
+    [[nodiscard]] std::vector<std::pair<std::string, double>> Read() const;
+
+private:
+    /**
+     * @brief Описание счётчика.
+     */
+    struct Event {
+        const char *name; //!< Имя счётчика в отчёте.
+        uint32_t type; //!< Тип события perf_event_attr::type.
+        uint64_t config; //!< Событие perf_event_attr::config.
+    };
+
+    std::array<int, NUM_COUNTERS> fds_{}; //!< Дескрипторы счётчиков, -1 для недоступных.
+
+    //! Описания всех счётчиков.
+    static const std::array<Event, NUM_COUNTERS> &Events() noexcept;
+};
+
+inline const std::array<PerfCounters::Event, PerfCounters::NUM_COUNTERS> &PerfCounters::Events() noexcept {
+#if defined(__linux__)
+    static const std::array<Event, NUM_COUNTERS> events = {{
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    }};
+#else
+    static const std::array<Event, NUM_COUNTERS> events = {{
+        {"cycles", 0U, 0U},
+        {"instructions", 0U, 0U},
+        {"cache_misses", 0U, 0U},
+        {"branch_misses", 0U, 0U},
+        {"page_faults", 0U, 0U},
+    }};
+#endif
+    return events;
+}
+
+inline PerfCounters::PerfCounters() noexcept {
+    fds_.fill(-1);
+#if defined(__linux__)
+    for (size_t i = 0; i < NUM_COUNTERS; ++i) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = Events()[i].type;
+        attr.config = Events()[i].config;
+        attr.disabled = 1U;
+        attr.exclude_kernel = 1U;
+        attr.exclude_hv = 1U;
+        attr.inherit = 1U;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0UL);
+        fds_[i] = static_cast<int>(fd);
+    }
+#endif
+}
+
+inline PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+inline bool PerfCounters::Available() const noexcept {
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline void PerfCounters::Start() noexcept {
+#if defined(__linux__)
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+inline void PerfCounters::Stop() noexcept {
+#if defined(__linux__)
+    for (const int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+#endif
+}
+
+inline std::vector<std::pair<std::string, double>> PerfCounters::Read() const {
+    std::vector<std::pair<std::string, double>> values;
+#if defined(__linux__)
+    for (size_t i = 0; i < NUM_COUNTERS; ++i) {
+        // value, time_enabled, time_running
+        std::array<uint64_t, 3> data{};
+        if (fds_[i] < 0 || read(fds_[i], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        double value = static_cast<double>(data[0]);
+        if (data[2] == 0U) {
+            // Счётчик ни разу не попал на PMU - значение неизвестно, а не нулевое
+            continue;
+        }
+        if (data[2] < data[1]) {
+            value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+        values.emplace_back(Events()[i].name, value);
+    }
+#endif
+    return values;
+}
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Вектор в заранее зарезервированном диапазоне адресов, который никогда не переносит элементы.
+ * @details При первом росте резервирует диапазон адресов под MaxCapacity элементов через
+ * mmap(PROT_NONE): физическая память при этом не выделяется. По мере роста страницы в начале
+ * диапазона открываются на чтение и запись через mprotect, и ядро выделяет их при первом
+ * обращении. Элементы лежат непрерывно, как в Vector, но рост никогда не копирует их:
+ * указатели, ссылки и итераторы остаются действительными, а аргументы EmplaceBack могут
+ * ссылаться на элементы вектора. Открытая часть растёт вдвое, чтобы количество вызовов
+ * mprotect было логарифмическим. Превысить MaxCapacity нельзя.
+ * @tparam T Тип элемента вектора.
+ */
+template <typename T>
+class PinnedVector {
+public:
+    using iterator = T *; //!< Итератор.
+    using const_iterator = const T *; //!< Константный итератор.
+
+    static_assert(alignof(T) <= 4096U, "PinnedVector places elements at a page boundary");
+
+    //! Размер диапазона адресов по умолчанию в байтах.
+    static constexpr size_t DEFAULT_RESERVED_BYTES = size_t{1} << 36U;
+    //! Наименьший размер открываемой за раз части диапазона в байтах.
+    static constexpr size_t MIN_COMMIT_BYTES = size_t{1} << 16U;
+
+    /**
+     * @brief Конструирует пустой вектор, не резервируя адреса.
+     * @param max_capacity Наибольшая вместимость.
+     */
+    explicit PinnedVector(size_t max_capacity = DEFAULT_RESERVED_BYTES / sizeof(T)) noexcept;
+
+    /**
+     * @brief Конструирует объект, копируя переданный.
+     * @details Копия получает такую же наибольшую вместимость.
+     * @param other Объект для копирования.
+     */
+    PinnedVector(const PinnedVector &other);
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @details Диапазон адресов переходит к новому объекту, элементы остаются на месте.
+     * @param other Объект для перемещения.
+     */
+    PinnedVector(PinnedVector &&other) noexcept;
+
+    /**
+     * @brief Присваивает объект, копируя себе содержимое переданного.
+     * @param rhs Объект для копирования.
+     * @return текущий объект.
+     */
+    PinnedVector &operator=(const PinnedVector &rhs);
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @param rhs Объект для перемещения.
+     * @return текущий объект.
+     */
+    PinnedVector &operator=(PinnedVector &&rhs) noexcept;
+
+    /**
+     * @brief Уничтожает элементы и освобождает диапазон адресов.
+     */
+    ~PinnedVector();
+
+    //! Получить итератор на начало вектора.
+    iterator begin() noexcept;
+    //! @overload PinnedVector::begin()
+    const_iterator begin() const noexcept;
+    //! Получить итератор на конец вектора.
+    iterator end() noexcept;
+    //! @overload PinnedVector::end()
+    const_iterator end() const noexcept;
+
+    /**
+     * @brief Меняет местами содержимое текущего объекта с содержимым переданного.
+     * @param other Объект, с которым нужно поменяться содержимым.
+     */
+    void Swap(PinnedVector &other) noexcept;
+
+    /**
+     * @brief Открывает страницы под указанное количество элементов.
+     * @param new_capacity Новая вместимость вектора.
+     * @throw std::length_error если new_capacity больше MaxCapacity.
+     * @throw std::system_error если не удалось зарезервировать или открыть страницы.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Меняет размер вектора на указанный.
+     * @details Новые элементы инициализируются значением. Даёт строгую гарантию безопасности.
+     * @param new_size Новый размер вектора.
+     */
+    void Resize(size_t new_size);
+
+    /**
+     * @brief Вставить объект в конец вектора.
+     * @tparam Obj Тип объекта для вставки.
+     * @param value Объект для вставки.
+     */
+    template <typename Obj>
+    void PushBack(Obj &&value);
+
+    /**
+     * @brief Конструирует и вставляет объект в конец вектора.
+     * @details Даёт строгую гарантию безопасности.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param args Аргументы для конструирования объекта.
+     * @return возвращает ссылку на сконструированный объект.
+     * @throw std::length_error если вектор уже вмещает MaxCapacity элементов.
+     */
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Удаляет последний элемент.
+     */
+    void PopBack() noexcept;
+
+    /**
+     * @brief Уничтожает все элементы, оставляя страницы открытыми.
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Возвращает ядру страницы, в которых нет элементов.
+     * @details Страницы закрываются обратно в PROT_NONE, диапазон адресов остаётся за вектором.
+     */
+    void ShrinkToFit() noexcept;
+
+    /**
+     * @brief Получает размер.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Получает вместимость - количество элементов в открытых страницах.
+     * @return вместимость.
+     */
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /**
+     * @brief Получает наибольшую вместимость - размер зарезервированного диапазона в элементах.
+     * @return наибольшую вместимость.
+     */
+    [[nodiscard]] size_t MaxCapacity() const noexcept;
+
+    /**
+     * @brief Получает указатель на первый элемент.
+     * @return указатель, не меняющийся при росте вектора.
+     */
+    T *Data() noexcept;
+
+    //! @overload PinnedVector::Data()
+    const T *Data() const noexcept;
+
+    /**
+     * @brief Получает доступ к элементу по индексу.
+     * @param index Индекс элемента.
+     * @return ссылку на элемент.
+     */
+    T &operator[](size_t index) noexcept;
+
+    //! @overload PinnedVector::operator[](size_t index)
+    const T &operator[](size_t index) const noexcept;
+
+private:
+    T *buffer_ = nullptr; //!< Начало диапазона адресов, nullptr - не зарезервирован.
+    size_t max_capacity_ = 0U; //!< Наибольшая вместимость.
+    size_t reserved_bytes_ = 0U; //!< Размер диапазона адресов в байтах.
+    size_t committed_bytes_ = 0U; //!< Размер открытой части диапазона в байтах.
+    size_t size_ = 0U; //!< Размер.
+
+    /**
+     * @brief Получает размер страницы.
+     * @return размер страницы в байтах.
+     */
+    static size_t PageSize() noexcept;
+
+    /**
+     * @brief Округляет размер вверх до целого числа страниц.
+     * @param bytes Размер в байтах.
+     * @return округлённый размер.
+     */
+    static size_t RoundUpToPage(size_t bytes) noexcept;
+
+    /**
+     * @brief Резервирует диапазон адресов, если он ещё не зарезервирован.
+     */
+    void ReserveAddressSpace();
+
+    /**
+     * @brief Открывает часть диапазона указанного размера.
+     * @param bytes Размер открытой части в байтах, кратный размеру страницы.
+     */
+    void Commit(size_t bytes);
+
+    /**
+     * @brief Уничтожает элементы и освобождает диапазон адресов.
+     */
+    void Release() noexcept;
+};
+
+template <typename T>
+PinnedVector<T>::PinnedVector(const size_t max_capacity) noexcept
+: max_capacity_(max_capacity) {
+}
+
+template <typename T>
+PinnedVector<T>::PinnedVector(const PinnedVector &other)
+: max_capacity_(other.max_capacity_) {
+    Reserve(other.size_);
+    try {
+        for (const T &item : other) {
+            EmplaceBack(item);
+        }
+    } catch (...) {
+        Release();
+        throw;
+    }
+}
+
+template <typename T>
+PinnedVector<T>::PinnedVector(PinnedVector &&other) noexcept
+: buffer_(std::exchange(other.buffer_, nullptr))
+, max_capacity_(other.max_capacity_)
+, reserved_bytes_(std::exchange(other.reserved_bytes_, 0U))
+, committed_bytes_(std::exchange(other.committed_bytes_, 0U))
+, size_(std::exchange(other.size_, 0U)) {
+}
+
+template <typename T>
+PinnedVector<T> &PinnedVector<T>::operator=(const PinnedVector &rhs) {
+    if (this != &rhs) {
+        PinnedVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename T>
+PinnedVector<T> &PinnedVector<T>::operator=(PinnedVector &&rhs) noexcept {
+    if (this != &rhs) {
+        PinnedVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+    }
+    return *this;
+}
+
+template <typename T>
+PinnedVector<T>::~PinnedVector() {
+    Release();
+}
+
+template <typename T>
+typename PinnedVector<T>::iterator PinnedVector<T>::begin() noexcept {
+    return buffer_;
+}
+
+template <typename T>
+typename PinnedVector<T>::const_iterator PinnedVector<T>::begin() const noexcept {
+    return buffer_;
+}
+
+template <typename T>
+typename PinnedVector<T>::iterator PinnedVector<T>::end() noexcept {
+    return buffer_ + size_;
+}
+
+template <typename T>
+typename PinnedVector<T>::const_iterator PinnedVector<T>::end() const noexcept {
+    return buffer_ + size_;
+}
+
+template <typename T>
+void PinnedVector<T>::Swap(PinnedVector &other) noexcept {
+    std::swap(buffer_, other.buffer_);
+    std::swap(max_capacity_, other.max_capacity_);
+    std::swap(reserved_bytes_, other.reserved_bytes_);
+    std::swap(committed_bytes_, other.committed_bytes_);
+    std::swap(size_, other.size_);
+}
+
+template <typename T>
+void PinnedVector<T>::Reserve(const size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    if (new_capacity > max_capacity_) {
+        throw std::length_error("PinnedVector: capacity exceeds reserved address space");
+    }
+    ReserveAddressSpace();
+    Commit(std::min(RoundUpToPage(new_capacity * sizeof(T)), reserved_bytes_));
+}
+
+template <typename T>
+void PinnedVector<T>::Resize(const size_t new_size) {
+    if (new_size <= size_) {
+        std::destroy(begin() + new_size, end());
+        size_ = new_size;
+        return;
+    }
+    Reserve(new_size);
+    std::uninitialized_value_construct(end(), begin() + new_size);
+    size_ = new_size;
+}
+
+template <typename T>
+template <typename Obj>
+void PinnedVector<T>::PushBack(Obj &&value) {
+    EmplaceBack(std::forward<Obj>(value));
+}
+
+template <typename T>
+template <typename... Args>
+T &PinnedVector<T>::EmplaceBack(Args &&...args) {
+    if (size_ == Capacity()) {
+        if (size_ == max_capacity_) {
+            throw std::length_error("PinnedVector: reserved address space is exhausted");
+        }
+        ReserveAddressSpace();
+        const size_t grown_bytes = std::max(committed_bytes_ * 2U, MIN_COMMIT_BYTES);
+        Commit(std::min(RoundUpToPage(std::max(grown_bytes, (size_ + 1U) * sizeof(T))), reserved_bytes_));
+    }
+    // Элементы не переносятся, поэтому аргументы, ссылающиеся на них, остаются действительными
+    T *const slot = new (buffer_ + size_) T(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+}
+
+template <typename T>
+void PinnedVector<T>::PopBack() noexcept {
+    assert(size_ != 0U);
+    --size_;
+    std::destroy_at(buffer_ + size_);
+}
+
+template <typename T>
+void PinnedVector<T>::Clear() noexcept {
+    std::destroy(begin(), end());
+    size_ = 0U;
+}
+
+template <typename T>
+void PinnedVector<T>::ShrinkToFit() noexcept {
+    const size_t used_bytes = RoundUpToPage(size_ * sizeof(T));
+    if (used_bytes >= committed_bytes_) {
+        return;
+    }
+    std::byte *const tail = reinterpret_cast<std::byte *>(buffer_) + used_bytes;
+    const size_t tail_bytes = committed_bytes_ - used_bytes;
+    // MADV_DONTNEED освобождает физические страницы, PROT_NONE снимает их с учёта overcommit
+    if (madvise(tail, tail_bytes, MADV_DONTNEED) == 0 && mprotect(tail, tail_bytes, PROT_NONE) == 0) {
+        committed_bytes_ = used_bytes;
+    }
+}
+
+template <typename T>
+size_t PinnedVector<T>::Size() const noexcept {
+    return size_;
+}
+
+template <typename T>
+size_t PinnedVector<T>::Capacity() const noexcept {
+    return std::min(committed_bytes_ / sizeof(T), max_capacity_);
+}
+
+template <typename T>
+size_t PinnedVector<T>::MaxCapacity() const noexcept {
+    return max_capacity_;
+}
+
+template <typename T>
+T *PinnedVector<T>::Data() noexcept {
+    return buffer_;
+}
+
+template <typename T>
+const T *PinnedVector<T>::Data() const noexcept {
+    return buffer_;
+}
+
+template <typename T>
+T &PinnedVector<T>::operator[](const size_t index) noexcept {
+    assert(index < size_);
+    return buffer_[index];
+}
+
+template <typename T>
+const T &PinnedVector<T>::operator[](const size_t index) const noexcept {
+    return const_cast<PinnedVector &>(*this)[index];
+}
+
+template <typename T>
+size_t PinnedVector<T>::PageSize() noexcept {
+    static const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+template <typename T>
+size_t PinnedVector<T>::RoundUpToPage(const size_t bytes) noexcept {
+    return (bytes + PageSize() - 1U) / PageSize() * PageSize();
+}
+
+template <typename T>
+void PinnedVector<T>::ReserveAddressSpace() {
+    if (buffer_ != nullptr) {
+        return;
+    }
+    if (max_capacity_ > (std::numeric_limits<size_t>::max() - PageSize()) / sizeof(T)) {
+        throw std::length_error("PinnedVector: max capacity is too large");
+    }
+    const size_t bytes = RoundUpToPage(max_capacity_ * sizeof(T));
+    void *base = mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    buffer_ = static_cast<T *>(base);
+    reserved_bytes_ = bytes;
+}
+
+template <typename T>
+void PinnedVector<T>::Commit(const size_t bytes) {
+    assert(bytes > committed_bytes_ && bytes <= reserved_bytes_);
+    std::byte *const tail = reinterpret_cast<std::byte *>(buffer_) + committed_bytes_;
+    if (mprotect(tail, bytes - committed_bytes_, PROT_READ | PROT_WRITE) != 0) {
+        throw std::system_error(errno, std::generic_category(), "mprotect");
+    }
+    committed_bytes_ = bytes;
+}
+
+template <typename T>
+void PinnedVector<T>::Release() noexcept {
+    Clear();
+    if (buffer_ != nullptr) {
+        munmap(buffer_, reserved_bytes_);
+        buffer_ = nullptr;
+        reserved_bytes_ = 0U;
+        committed_bytes_ = 0U;
+    }
+}
@@ -2,28 +2,130 @@
 
 #include <algorithm>
 #include <cassert>
+#include <concepts>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <new>
+#include <type_traits>
 #include <utility>
 
+/**
+ * @brief Аллокатор, умеющий менять размер блока с побайтовым сохранением содержимого.
+ * @details Такой аллокатор предоставляет метод reallocate(p, old_n, new_n) в духе realloc.
+ */
+template <typename Allocator>
+concept ReallocatingAllocator = requires(Allocator alloc,
+                                         typename std::allocator_traits<Allocator>::pointer p,
+                                         size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<typename std::allocator_traits<Allocator>::pointer>;
+};
+
+/**
+ * @brief Аллокатор, умеющий расширять блок на месте, не перемещая его.
+ * @details Такой аллокатор предоставляет метод expand(p, old_n, new_n), который возвращает
+ * true, если блок по адресу p удалось расширить до new_n элементов без переноса.
+ */
+template <typename Allocator>
+concept ExpandingAllocator = requires(Allocator alloc,
+                                      typename std::allocator_traits<Allocator>::pointer p,
+                                      size_t n) {
+    { alloc.expand(p, n, n) } -> std::same_as<bool>;
+};
+
+/**
+ * @brief Аллокатор, умеющий выделять заполненную нулями память дешевле, чем memset.
+ * @details Такой аллокатор предоставляет метод allocate_zeroed(n) в духе calloc: свежие
+ * страницы ядра уже обнулены, поэтому большой блок выделяется за O(1), а физическая память
+ * занимается только под страницы, к которым действительно обращались. Освобождается такой
+ * блок обычным deallocate.
+ */
+template <typename Allocator>
+concept ZeroingAllocator = requires(Allocator alloc, size_t n) {
+    { alloc.allocate_zeroed(n) } -> std::same_as<typename std::allocator_traits<Allocator>::pointer>;
+};
+
+/**
+ * @brief Признак того, что нулевые байты - это значение типа после инициализации значением.
+ * @details Для таких типов инициализацию значением T() можно заменить заполненной нулями
+ * памятью. По умолчанию таковыми считаются арифметические типы, перечисления и указатели,
+ * но не указатели на члены, у которых нулевое значение в популярных ABI не нулевое побайтово.
+ * Признак учитывается только для тривиальных типов. Для своих типов его можно включить
+ * специализацией:
+ * @code
+ * template <>
+ * struct IsZeroInitializable<MyPod> : std::true_type {};
+ * @endcode
+ * @tparam T Тип объекта.
+ */
+template <typename T>
+struct IsZeroInitializable : std::bool_constant<std::is_scalar_v<T> && !std::is_member_pointer_v<T>> {};
+
+//! Значение признака IsZeroInitializable для тривиальных типов.
+template <typename T>
+inline constexpr bool IS_ZERO_INITIALIZABLE = std::is_trivial_v<T> && IsZeroInitializable<T>::value;
+
+/**
+ * @brief Метка конструктора RawMemory, выделяющего заполненную нулями память.
+ */
+struct ZeroFilledTag {};
+
+//! Метка заполненной нулями памяти.
+inline constexpr ZeroFilledTag ZERO_FILLED{};
+
 /**
  * @brief Простой аллокатор памяти.
+ * @details Сырая память запрашивается и освобождается через переданный аллокатор
+ * с соблюдением семантики std::allocator_traits. Аллокатор хранится вместе с памятью
+ * и перемещается вместе с ней, поскольку только он может её освободить.
  * @tparam T Тип объекта, который будет размещаться в памяти.
+ * @tparam Allocator Тип аллокатора.
  */
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class RawMemory {
 public:
+    using allocator_type = Allocator; //!< Тип аллокатора.
+    using AllocTraits = std::allocator_traits<Allocator>; //!< Свойства аллокатора.
+
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>,
+                  "Allocator::value_type must be the same as T");
+    static_assert(std::is_same_v<typename AllocTraits::pointer, T *>,
+                  "Allocator::pointer must be a raw pointer");
+
+    //! Поддерживает ли аллокатор изменение размера блока.
+    static constexpr bool CAN_REALLOCATE = ReallocatingAllocator<Allocator>;
+
+    //! Поддерживает ли аллокатор расширение блока на месте.
+    static constexpr bool CAN_EXPAND = ExpandingAllocator<Allocator>;
+
+    //! Умеет ли аллокатор выделять заполненную нулями память без memset.
+    static constexpr bool CAN_ALLOCATE_ZEROED = ZeroingAllocator<Allocator>;
+
     /**
      * @brief Конструирует по умолчанию объект без выделенной памяти.
      */
     RawMemory() = default;
 
+    /**
+     * @brief Конструирует объект без выделенной памяти с указанным аллокатором.
+     * @param alloc Аллокатор.
+     */
+    explicit RawMemory(const Allocator &alloc) noexcept;
+
     /**
      * @brief Конструирует объект, который выделяет память с указанной вместимостью.
      * @param capacity Вместимость памяти.
+     * @param alloc Аллокатор.
      */
-    explicit RawMemory(size_t capacity);
+    explicit RawMemory(size_t capacity, const Allocator &alloc = Allocator());
+
+    /**
+     * @brief Конструирует объект, который выделяет заполненную нулями память с указанной вместимостью.
+     * @details Если аллокатор не умеет выделять такую память, она обнуляется через memset.
+     * @param capacity Вместимость памяти.
+     * @param alloc Аллокатор.
+     */
+    RawMemory(size_t capacity, ZeroFilledTag, const Allocator &alloc = Allocator());
 
     //! Запрет на копирование.
     RawMemory(const RawMemory &) = delete;
@@ -38,6 +140,7 @@ public:
 
     /**
      * @brief Присваивает значение объекта справа, перемещая его содержимое себе.
+     * @details Вместе с памятью перемещается и аллокатор.
      * @param rhs Присваиваемый объект.
      * @return Возвращает текущий объект.
      */
@@ -70,6 +173,7 @@ public:
 
     /**
      * @brief Поменять местами текущее содержимое с содержимом переданного объекта.
+     * @details Аллокаторы меняются местами вместе с памятью.
      * @param other Объект, с которым нужно поменять внутренним содержимым.
      */
     void Swap(RawMemory &other) noexcept;
@@ -89,7 +193,32 @@ public:
      */
     [[nodiscard]] size_t Capacity() const;
 
+    /**
+     * @brief Получает аллокатор.
+     * @return копию аллокатора.
+     */
+    [[nodiscard]] Allocator GetAllocator() const noexcept;
+
+    /**
+     * @brief Меняет вместимость, сохраняя содержимое памяти побайтово.
+     * @details Аллокатор по возможности расширяет блок на месте (например, при помощи realloc
+     * или mremap), иначе переносит его. Допустимо только для тривиально релоцируемых объектов,
+     * так как адрес объектов может измениться. При исключении память остаётся прежней.
+     * @param new_capacity Новая вместимость.
+     */
+    void Reallocate(size_t new_capacity) requires ReallocatingAllocator<Allocator>;
+
+    /**
+     * @brief Пытается увеличить вместимость, не перемещая память.
+     * @details Адреса объектов не меняются, поэтому допустимо для любых типов.
+     * @param new_capacity Новая вместимость.
+     * @return true, если аллокатор расширил блок на месте; false, если это невозможно
+     * или аллокатор не поддерживает расширение.
+     */
+    bool TryExpand(size_t new_capacity) noexcept;
+
 private:
+    [[no_unique_address]] Allocator alloc_; //!< Аллокатор.
     T *buffer_ = nullptr; //!< Выделенная память.
     size_t capacity_ = 0U; //!< Вместимость хранилища, т.е. сколько поместится объектов.
 
@@ -98,94 +227,164 @@ private:
      * @param n Количество элементов.
      * @return указатель на начало выделенной памяти.
      */
-    static T *Allocate(size_t n);
+    T *Allocate(size_t n);
+
+    /**
+     * @brief Выделяет заполненную нулями память под указанное количество элементов.
+     * @param n Количество элементов.
+     * @return указатель на начало выделенной памяти.
+     */
+    T *AllocateZeroed(size_t n);
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
     /**
      * @brief Освобождает переданную память.
      * @warning Предполагает, что будет передан указатель на память, которая была выделена
-     * при помощи Allocate.
+     * при помощи Allocate этим же аллокатором.
      * @see Allocate(size_t n)
      * @param buf память, которую нужно освободить.
+     * @param n Количество элементов, под которое выделялась память.
      */
-    static void Deallocate(T *buf) noexcept;
+    void Deallocate(T *buf, size_t n) noexcept;
 };
 
-template<typename T>
-RawMemory<T>::RawMemory(const size_t capacity)
-: buffer_(Allocate(capacity))
+template<typename T, typename Allocator>
+RawMemory<T, Allocator>::RawMemory(const Allocator &alloc) noexcept
+: alloc_(alloc) {
+}
+
+template<typename T, typename Allocator>
+RawMemory<T, Allocator>::RawMemory(const size_t capacity, const Allocator &alloc)
+: alloc_(alloc)
+, buffer_(Allocate(capacity))
 , capacity_(capacity) {
 }
 
-template<typename T>
-RawMemory<T>::RawMemory(RawMemory &&other) noexcept
-: buffer_(nullptr)
-, capacity_(0U) {
-    std::swap(buffer_, other.buffer_);
-    std::swap(capacity_, other.capacity_);
+template<typename T, typename Allocator>
+RawMemory<T, Allocator>::RawMemory(const size_t capacity, ZeroFilledTag /*tag*/, const Allocator &alloc)
+: alloc_(alloc)
+, buffer_(AllocateZeroed(capacity))
+, capacity_(capacity) {
+}
+
+template<typename T, typename Allocator>
+RawMemory<T, Allocator>::RawMemory(RawMemory &&other) noexcept
+: alloc_(std::move(other.alloc_))
+, buffer_(std::exchange(other.buffer_, nullptr))
+, capacity_(std::exchange(other.capacity_, 0U)) {
 }
 
-template<typename T>
-RawMemory<T> &RawMemory<T>::operator=(RawMemory &&rhs) noexcept {
-    Deallocate(buffer_);
-    std::swap(buffer_, rhs.buffer_);
-    capacity_ = std::exchange(rhs.capacity_, 0U);
+template<typename T, typename Allocator>
+RawMemory<T, Allocator> &RawMemory<T, Allocator>::operator=(RawMemory &&rhs) noexcept {
+    if (this != &rhs) {
+        Deallocate(buffer_, capacity_);
+        alloc_ = std::move(rhs.alloc_);
+        buffer_ = std::exchange(rhs.buffer_, nullptr);
+        capacity_ = std::exchange(rhs.capacity_, 0U);
+    }
+    return *this;
 }
 
-template<typename T>
-RawMemory<T>::~RawMemory() {
-    Deallocate(buffer_);
+template<typename T, typename Allocator>
+RawMemory<T, Allocator>::~RawMemory() {
+    Deallocate(buffer_, capacity_);
 }
 
-template<typename T>
-T *RawMemory<T>::operator+(const size_t offset) noexcept {
+template<typename T, typename Allocator>
+T *RawMemory<T, Allocator>::operator+(const size_t offset) noexcept {
     assert(offset <= capacity_);
     return buffer_ + offset;
 }
 
-template<typename T>
-const T *RawMemory<T>::operator+(const size_t offset) const noexcept {
+template<typename T, typename Allocator>
+const T *RawMemory<T, Allocator>::operator+(const size_t offset) const noexcept {
     return const_cast<RawMemory &>(*this) + offset;
 }
 
-template<typename T>
-const T &RawMemory<T>::operator[](const size_t index) const noexcept {
+template<typename T, typename Allocator>
+const T &RawMemory<T, Allocator>::operator[](const size_t index) const noexcept {
     return const_cast<RawMemory&>(*this)[index];
 }
 
-template<typename T>
-T &RawMemory<T>::operator[](const size_t index) noexcept {
+template<typename T, typename Allocator>
+T &RawMemory<T, Allocator>::operator[](const size_t index) noexcept {
     assert(index < capacity_);
     return buffer_[index];
 }
 
-template<typename T>
-void RawMemory<T>::Swap(RawMemory &other) noexcept {
+template<typename T, typename Allocator>
+void RawMemory<T, Allocator>::Swap(RawMemory &other) noexcept {
+    using std::swap;
+    swap(alloc_, other.alloc_);
     std::swap(buffer_, other.buffer_);
     std::swap(capacity_, other.capacity_);
 }
 
-template<typename T>
-const T *RawMemory<T>::GetAddress() const noexcept {
+template<typename T, typename Allocator>
+const T *RawMemory<T, Allocator>::GetAddress() const noexcept {
     return buffer_;
 }
 
-template<typename T>
-T *RawMemory<T>::GetAddress() noexcept {
+template<typename T, typename Allocator>
+T *RawMemory<T, Allocator>::GetAddress() noexcept {
     return buffer_;
 }
 
-template<typename T>
-size_t RawMemory<T>::Capacity() const {
+template<typename T, typename Allocator>
+size_t RawMemory<T, Allocator>::Capacity() const {
     return capacity_;
 }
 
-template<typename T>
-T *RawMemory<T>::Allocate(const size_t n) {
-    return (n != 0U) ? static_cast<T *>(operator new(n * sizeof(T))) : nullptr;
+template<typename T, typename Allocator>
+Allocator RawMemory<T, Allocator>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+template<typename T, typename Allocator>
+void RawMemory<T, Allocator>::Reallocate(const size_t new_capacity) requires ReallocatingAllocator<Allocator> {
+    if (buffer_ == nullptr) {
+        buffer_ = Allocate(new_capacity);
+    } else if (new_capacity == 0U) {
+        Deallocate(buffer_, capacity_);
+        buffer_ = nullptr;
+    } else {
+        buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+    }
+    capacity_ = new_capacity;
+}
+
+template<typename T, typename Allocator>
+bool RawMemory<T, Allocator>::TryExpand(const size_t new_capacity) noexcept {
+    if constexpr (CAN_EXPAND) {
+        if (buffer_ != nullptr && alloc_.expand(buffer_, capacity_, new_capacity)) {
+            capacity_ = new_capacity;
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename T, typename Allocator>
+T *RawMemory<T, Allocator>::Allocate(const size_t n) {
+    return (n != 0U) ? AllocTraits::allocate(alloc_, n) : nullptr;
+}
+
+template<typename T, typename Allocator>
+T *RawMemory<T, Allocator>::AllocateZeroed(const size_t n) {
+    if (n == 0U) {
+        return nullptr;
+    }
+    if constexpr (CAN_ALLOCATE_ZEROED) {
+        return alloc_.allocate_zeroed(n);
+    } else {
+        T *buf = AllocTraits::allocate(alloc_, n);
+        std::memset(static_cast<void *>(buf), 0, n * sizeof(T));
+        return buf;
+    }
 }
 
-template<typename T>
-void RawMemory<T>::Deallocate(T *buf) noexcept {
-    operator delete(buf);
-}
\ No newline at end of file
+template<typename T, typename Allocator>
+void RawMemory<T, Allocator>::Deallocate(T *buf, const size_t n) noexcept {
+    if (buf != nullptr) {
+        AllocTraits::deallocate(alloc_, buf, n);
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Признак тривиальной релоцируемости типа.
+ * @details Тип тривиально релоцируем, если перенос объекта в другое место памяти побайтовым
+ * копированием с последующим "забыванием" исходника (без вызова деструктора) эквивалентен
+ * перемещению с последующим уничтожением исходного объекта. По умолчанию таковыми считаются
+ * тривиально копируемые типы. Для своих типов признак можно включить специализацией:
+ * @code
+ * template <>
+ * struct IsTriviallyRelocatable<MyType> : std::true_type {};
+ * @endcode
+ * @tparam T Тип объекта.
+ */
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+//! std::unique_ptr со стандартным удалителем хранит только указатель.
+template <typename T>
+struct IsTriviallyRelocatable<std::unique_ptr<T>> : std::true_type {};
+
+//! Значение признака IsTriviallyRelocatable.
+template <typename T>
+inline constexpr bool IS_TRIVIALLY_RELOCATABLE = IsTriviallyRelocatable<T>::value;
+
+/**
+ * @brief Побайтово переносит элементы между непересекающимися участками памяти.
+ * @details После вызова объекты считаются живущими по адресу to, а память по адресу from -
+ * сырой. Деструкторы исходных объектов вызывать нельзя.
+ * @tparam T Тривиально релоцируемый тип.
+ * @param from Начало памяти откуда нужно релоцировать.
+ * @param n Количество элементов.
+ * @param to Начало памяти, в которую нужно релоцировать.
+ */
+template <typename T>
+void RelocateBitwise(T *from, size_t n, T *to) noexcept {
+    static_assert(IS_TRIVIALLY_RELOCATABLE<T>);
+    if (n != 0U) {
+        std::memcpy(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(T));
+    }
+}
+
+/**
+ * @brief Побайтово сдвигает элементы внутри одного участка памяти.
+ * @details Аналог RelocateBitwise для пересекающихся участков.
+ * @tparam T Тривиально релоцируемый тип.
+ * @param from Начало памяти откуда нужно релоцировать.
+ * @param n Количество элементов.
+ * @param to Начало памяти, в которую нужно релоцировать.
+ */
+template <typename T>
+void RelocateBitwiseOverlapping(T *from, size_t n, T *to) noexcept {
+    static_assert(IS_TRIVIALLY_RELOCATABLE<T>);
+    if (n != 0U) {
+        std::memmove(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(T));
+    }
+}
+
+/**
+ * @brief Релоцирует элементы из одного участка памяти в другой, непересекающийся с ним.
+ * @details Тривиально релоцируемые типы копируются побайтово. Остальные перемещаются, если
+ * перемещение не бросает исключений или копирование недоступно, иначе копируются, чтобы
+ * при исключении исходные элементы остались нетронутыми. Исходные элементы после вызова
+ * нужно уничтожить при помощи DestroyRelocated.
+ * @param from Начало памяти откуда нужно релоцировать.
+ * @param n Количество элементов для релокации.
+ * @param to Начало памяти, в которую нужно релоцировать.
+ */
+template <typename T>
+void UninitializedRelocate(T *from, size_t n, T *to) {
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        RelocateBitwise(from, n, to);
+    } else if constexpr (std::is_nothrow_move_constructible_v<T> || (!std::is_copy_constructible_v<T>)) {
+        std::uninitialized_move_n(from, n, to);
+    } else {
+        std::uninitialized_copy_n(from, n, to);
+    }
+}
+
+/**
+ * @brief Уничтожает исходные элементы после релокации при помощи UninitializedRelocate.
+ * @details Для тривиально релоцируемых типов ничего не делает: их исходники уже "забыты".
+ * @param from Начало памяти откуда релоцировали.
+ * @param n Количество релоцированных элементов.
+ */
+template <typename T>
+void DestroyRelocated(T *from, size_t n) noexcept {
+    if constexpr (!IS_TRIVIALLY_RELOCATABLE<T>) {
+        std::destroy_n(from, n);
+    }
+}
+
+/**
+ * @brief Конструирует элемент перед элементом dist участка, у которого есть место ещё под один.
+ * @details Элемент сначала создаётся во временном объекте, поэтому аргументы могут ссылаться
+ * на элементы участка. Хвост сдвигается на одну позицию, для тривиально релоцируемых типов -
+ * через memmove. Общий код вставки без роста для Vector и SmallVector.
+ * @tparam T Тип элемента.
+ * @tparam Args Типы аргументов для конструирования.
+ * @param data Начало участка.
+ * @param size Количество элементов, больше dist.
+ * @param dist Индекс позиции вставки.
+ * @param args Аргументы для конструирования.
+ */
+template <typename T, typename... Args>
+void EmplaceShifting(T *data, size_t size, size_t dist, Args &&...args) {
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        alignas(T) std::byte temp_storage[sizeof(T)];
+        T *temp = new (temp_storage) T(std::forward<Args>(args)...);
+        RelocateBitwiseOverlapping(data + dist, size - dist, data + (dist + 1U));
+        RelocateBitwise(temp, 1U, data + dist);
+    } else {
+        T temp(std::forward<Args>(args)...);
+        new (data + size) T(std::move(data[size - 1U]));
+        std::move_backward(data + dist, data + (size - 1U), data + size);
+        data[dist] = std::move(temp);
+    }
+}
+
+/**
+ * @brief Релоцирует элементы в новую память, конструируя по дороге новый элемент в позиции dist.
+ * @details Новый элемент создаётся первым, пока аргументы, возможно ссылающиеся на исходные
+ * элементы, ещё живы. Даёт строгую гарантию безопасности: при исключении новая память пуста,
+ * а исходные элементы не тронуты. После успеха исходные элементы уже уничтожены.
+ * Общий код вставки с ростом для Vector и SmallVector.
+ * @tparam T Тип элемента.
+ * @tparam Args Типы аргументов для конструирования.
+ * @param from Начало исходных элементов.
+ * @param size Количество исходных элементов.
+ * @param dist Индекс позиции нового элемента, не больше size.
+ * @param to Новая память под size + 1 элемент.
+ * @param args Аргументы для конструирования.
+ */
+template <typename T, typename... Args>
+void RelocateEmplacing(T *from, size_t size, size_t dist, T *to, Args &&...args) {
+    new (to + dist) T(std::forward<Args>(args)...);
+    try {
+        UninitializedRelocate(from, dist, to);
+    } catch (...) {
+        std::destroy_at(to + dist);
+        throw;
+    }
+    try {
+        UninitializedRelocate(from + dist, size - dist, to + (dist + 1U));
+    } catch (...) {
+        std::destroy_n(to, dist + 1U);
+        throw;
+    }
+    DestroyRelocated(from, size);
+}
+
+/**
+ * @brief Стирает элемент dist участка, сдвигая хвост на одну позицию.
+ * @details Для тривиально релоцируемых типов хвост сдвигается через memmove. Размер
+ * участка уменьшает вызывающий. Общий код Erase для Vector и SmallVector.
+ * @tparam T Тип элемента.
+ * @param data Начало участка.
+ * @param size Количество элементов, больше dist.
+ * @param dist Индекс стираемого элемента.
+ */
+template <typename T>
+void EraseShifting(T *data, size_t size, size_t dist) {
+    assert(dist < size);
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        std::destroy_at(data + dist);
+        // Проверка видна компилятору: без неё он не доказывает, что длина хвоста не переполнена
+        if (dist + 1U < size) {
+            RelocateBitwiseOverlapping(data + (dist + 1U), size - (dist + 1U), data + dist);
+        }
+    } else {
+        std::move(data + (dist + 1U), data + size, data + dist);
+        std::destroy_at(data + (size - 1U));
+    }
+}
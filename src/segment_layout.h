@@ -0,0 +1,56 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <limits>
+
+/**
+ * @brief Раскладка индексов по сегментам растущего вдвое размера.
+ * @details Сегмент k вмещает FirstSegmentSize * 2^k элементов и начинается с индекса
+ * FirstSegmentSize * (2^k - 1), поэтому сегмент и смещение в нём вычисляются за O(1)
+ * по старшему биту индекса. Каталог из MAX_SEGMENTS сегментов покрывает все индексы size_t.
+ * @tparam FirstSegmentSize Вместимость первого сегмента, степень двойки.
+ */
+template <size_t FirstSegmentSize>
+struct GeometricSegments {
+    static_assert(std::has_single_bit(FirstSegmentSize), "First segment size must be a power of two");
+
+    //! Наибольшее количество сегментов.
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - std::bit_width(FirstSegmentSize) + 2U;
+
+    /**
+     * @brief Положение элемента: номер сегмента и индекс внутри него.
+     */
+    struct Location {
+        size_t segment; //!< Номер сегмента.
+        size_t offset; //!< Индекс внутри сегмента.
+    };
+
+    /**
+     * @brief Вычисляет вместимость сегмента.
+     * @param segment Номер сегмента.
+     * @return вместимость.
+     */
+    static constexpr size_t Capacity(size_t segment) noexcept {
+        return FirstSegmentSize << segment;
+    }
+
+    /**
+     * @brief Вычисляет индекс первого элемента сегмента.
+     * @param segment Номер сегмента.
+     * @return индекс.
+     */
+    static constexpr size_t Start(size_t segment) noexcept {
+        return FirstSegmentSize * ((size_t{1} << segment) - 1U);
+    }
+
+    /**
+     * @brief Вычисляет положение элемента.
+     * @param index Индекс элемента.
+     * @return положение.
+     */
+    static constexpr Location Locate(size_t index) noexcept {
+        const size_t segment = std::bit_width(index / FirstSegmentSize + 1U) - 1U;
+        return Location{segment, index - Start(segment)};
+    }
+};
@@ -0,0 +1,553 @@
+#pragma once
+
+#include "segment_layout.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Вектор, который растёт сегментами и никогда не переносит элементы.
+ * @details Элементы хранятся в сегментах растущего вдвое размера, адреса которых лежат
+ * в небольшом каталоге фиксированного размера. Сегменты выделяются единственным
+ * аллокатором вектора, так что подходит и аллокатор без конструктора по умолчанию. Рост добавляет новый сегмент, не трогая
+ * существующие элементы, поэтому указатели и ссылки на элементы остаются действительными до
+ * их удаления, а время EmplaceBack не зависит от размера вектора. Доступ по индексу - O(1):
+ * сегмент определяется по старшему биту индекса. Итераторы произвольного доступа переходят
+ * между сегментами сами. Память используется не более чем вдвое сверх размера, как у Vector.
+ * @tparam T Тип элемента вектора.
+ * @tparam Allocator Тип аллокатора.
+ * @tparam FirstSegmentSize Вместимость первого сегмента, степень двойки.
+ * @see GeometricSegments
+ */
+template <typename T, typename Allocator = std::allocator<T>, size_t FirstSegmentSize = 16U>
+class SegmentedVector {
+public:
+    using allocator_type = Allocator; //!< Тип аллокатора.
+    using Layout = GeometricSegments<FirstSegmentSize>; //!< Раскладка индексов по сегментам.
+
+    /**
+     * @brief Итератор произвольного доступа по элементам.
+     * @details Помнит текущий элемент и конец его сегмента, так что последовательный обход
+     * не вычисляет положение каждого элемента заново.
+     * @tparam IsConst Константный ли итератор.
+     */
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using Owner = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>; //!< Тип вектора.
+        using iterator_category = std::random_access_iterator_tag; //!< Категория итератора.
+        using value_type = T; //!< Тип элемента.
+        using difference_type = std::ptrdiff_t; //!< Тип расстояния.
+        using pointer = std::conditional_t<IsConst, const T *, T *>; //!< Тип указателя.
+        using reference = std::conditional_t<IsConst, const T &, T &>; //!< Тип ссылки.
+
+        Iterator() noexcept = default;
+
+        //! Конструирует итератор на элемент index вектора owner.
+        Iterator(Owner *owner, const size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+            Reseat();
+        }
+
+        //! Неконстантный итератор преобразуется в константный.
+        operator Iterator<true>() const noexcept {  // NOLINT
+            return Iterator<true>(owner_, index_);
+        }
+
+        //! Получает индекс элемента.
+        [[nodiscard]] size_t Index() const noexcept {
+            return index_;
+        }
+
+        //! Получает ссылку на элемент.
+        reference operator*() const noexcept {
+            return *current_;
+        }
+
+        //! Получает указатель на элемент.
+        pointer operator->() const noexcept {
+            return current_;
+        }
+
+        //! Получает ссылку на элемент со смещением.
+        reference operator[](const difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        //! Переходит к следующему элементу.
+        Iterator &operator++() noexcept {
+            ++index_;
+            if (++current_ == segment_end_) {
+                Reseat();
+            }
+            return *this;
+        }
+
+        //! Переходит к следующему элементу.
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        //! Переходит к предыдущему элементу.
+        Iterator &operator--() noexcept {
+            --index_;
+            Reseat();
+            return *this;
+        }
+
+        //! Переходит к предыдущему элементу.
+        Iterator operator--(int) noexcept {
+            Iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        //! Сдвигает итератор.
+        Iterator &operator+=(const difference_type offset) noexcept {
+            index_ += offset;
+            Reseat();
+            return *this;
+        }
+
+        //! Сдвигает итератор назад.
+        Iterator &operator-=(const difference_type offset) noexcept {
+            return *this += -offset;
+        }
+
+        //! Получает сдвинутый итератор.
+        friend Iterator operator+(Iterator it, const difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        //! Получает сдвинутый итератор.
+        friend Iterator operator+(const difference_type offset, Iterator it) noexcept {
+            return it += offset;
+        }
+
+        //! Получает сдвинутый назад итератор.
+        friend Iterator operator-(Iterator it, const difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        //! Получает расстояние между итераторами.
+        friend difference_type operator-(const Iterator &lhs, const Iterator &rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        //! Сравнивает итераторы одного вектора.
+        bool operator==(const Iterator &other) const noexcept {
+            return index_ == other.index_;
+        }
+
+        //! Упорядочивает итераторы одного вектора.
+        std::strong_ordering operator<=>(const Iterator &other) const noexcept {
+            return index_ <=> other.index_;
+        }
+
+    private:
+        Owner *owner_ = nullptr; //!< Вектор.
+        size_t index_ = 0U; //!< Индекс элемента.
+        pointer current_ = nullptr; //!< Элемент, nullptr за пределами выделенных сегментов.
+        pointer segment_end_ = nullptr; //!< Конец сегмента элемента.
+
+        //! Находит элемент по индексу.
+        void Reseat() noexcept {
+            const typename Layout::Location location = Layout::Locate(index_);
+            if (owner_ == nullptr || location.segment >= owner_->num_segments_) {
+                current_ = nullptr;
+                segment_end_ = nullptr;
+                return;
+            }
+            pointer const segment = owner_->segments_[location.segment];
+            current_ = segment + location.offset;
+            segment_end_ = segment + Layout::Capacity(location.segment);
+        }
+    };
+
+    using iterator = Iterator<false>; //!< Итератор.
+    using const_iterator = Iterator<true>; //!< Константный итератор.
+
+    /**
+     * @brief Получить итератор на начало вектора.
+     * @return итератор на начало вектора.
+     */
+    iterator begin() noexcept;
+
+    //! @overload SegmentedVector::begin()
+    const_iterator begin() const noexcept;
+
+    //! @overload SegmentedVector::begin()
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Получить итератор на конец вектора.
+     * @return итератор на конец вектора.
+     */
+    iterator end() noexcept;
+
+    //! @overload SegmentedVector::end()
+    const_iterator end() const noexcept;
+
+    //! @overload SegmentedVector::end()
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Конструирует пустой вектор.
+     */
+    SegmentedVector() = default;
+
+    /**
+     * @brief Конструирует пустой вектор с указанным аллокатором.
+     * @param alloc Аллокатор.
+     */
+    explicit SegmentedVector(const Allocator &alloc) noexcept;
+
+    /**
+     * @brief Конструирует объект, копируя переданный.
+     * @param other Объект для копирования.
+     */
+    SegmentedVector(const SegmentedVector &other);
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @param other Объект для перемещения.
+     */
+    SegmentedVector(SegmentedVector &&other) noexcept;
+
+    /**
+     * @brief Присваивает объект, копируя себе содержимое переданного.
+     * @param rhs Объект для копирования.
+     * @return текущий объект.
+     */
+    SegmentedVector &operator=(const SegmentedVector &rhs);
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @details Прежние элементы уничтожаются сразу, а не переходят к rhs.
+     * @param rhs Объект для перемещения.
+     * @return текущий объект.
+     */
+    SegmentedVector &operator=(SegmentedVector &&rhs) noexcept;
+
+    /**
+     * @brief Деструктор.
+     */
+    ~SegmentedVector();
+
+    /**
+     * @brief Меняет местами содержимое текущего объекта с содержимым переданного.
+     * @param other Объект, с которым нужно поменяться содержимым.
+     */
+    void Swap(SegmentedVector &other) noexcept;
+
+    /**
+     * @brief Резервирует место под указанное количество элементов, добавляя сегменты.
+     * @param new_capacity Новая вместимость вектора.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Меняет размер вектора на указанный.
+     * @details Новые элементы инициализируются значением. Даёт строгую гарантию безопасности.
+     * @param new_size Новый размер вектора.
+     */
+    void Resize(size_t new_size);
+
+    /**
+     * @brief Вставить объект в конец вектора.
+     * @tparam Obj Тип объекта для вставки.
+     * @param value Объект для вставки.
+     */
+    template <typename Obj>
+    void PushBack(Obj &&value);
+
+    /**
+     * @brief Конструирует и вставляет объект в конец вектора.
+     * @details Существующие элементы не переносятся, поэтому аргументы могут ссылаться на них.
+     * Даёт строгую гарантию безопасности.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param args Аргументы для конструирования объекта.
+     * @return возвращает ссылку на сконструированный объект.
+     */
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Удаляет последний элемент.
+     */
+    void PopBack() noexcept;
+
+    /**
+     * @brief Уничтожает все элементы, сохраняя сегменты.
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Освобождает сегменты, в которых нет элементов.
+     */
+    void ShrinkToFit() noexcept;
+
+    /**
+     * @brief Получает размер.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Получает вместимость.
+     * @return вместимость.
+     */
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /**
+     * @brief Получает доступ к элементу по индексу.
+     * @param index Индекс элемента.
+     * @return ссылку на элемент.
+     */
+    T &operator[](size_t index) noexcept;
+
+    //! @overload SegmentedVector::operator[](size_t index)
+    const T &operator[](size_t index) const noexcept;
+
+    /**
+     * @brief Получает аллокатор.
+     * @return копию аллокатора.
+     */
+    [[nodiscard]] Allocator GetAllocator() const noexcept;
+
+private:
+    using AllocTraits = std::allocator_traits<Allocator>; //!< Свойства аллокатора.
+
+    [[no_unique_address]] Allocator alloc_; //!< Аллокатор.
+    std::array<T *, Layout::MAX_SEGMENTS> segments_{}; //!< Каталог сегментов.
+    size_t num_segments_ = 0U; //!< Количество выделенных сегментов.
+    size_t size_ = 0U; //!< Размер.
+
+    /**
+     * @brief Выделяет следующий сегмент.
+     */
+    void AddSegment();
+
+    /**
+     * @brief Освобождает сегменты, начиная с first_segment.
+     * @details Элементов в этих сегментах уже быть не должно.
+     * @param first_segment Первый освобождаемый сегмент.
+     */
+    void FreeSegmentsFrom(size_t first_segment) noexcept;
+
+    /**
+     * @brief Уничтожает элементы, начиная с new_size, и уменьшает размер.
+     * @param new_size Новый размер вектора.
+     */
+    void DestroyFrom(size_t new_size) noexcept;
+};
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename SegmentedVector<T, Allocator, FirstSegmentSize>::iterator SegmentedVector<T, Allocator, FirstSegmentSize>::begin() noexcept {
+    return iterator(this, 0U);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename SegmentedVector<T, Allocator, FirstSegmentSize>::const_iterator SegmentedVector<T, Allocator, FirstSegmentSize>::begin() const noexcept {
+    return cbegin();
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename SegmentedVector<T, Allocator, FirstSegmentSize>::const_iterator SegmentedVector<T, Allocator, FirstSegmentSize>::cbegin() const noexcept {
+    return const_iterator(this, 0U);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename SegmentedVector<T, Allocator, FirstSegmentSize>::iterator SegmentedVector<T, Allocator, FirstSegmentSize>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename SegmentedVector<T, Allocator, FirstSegmentSize>::const_iterator SegmentedVector<T, Allocator, FirstSegmentSize>::end() const noexcept {
+    return cend();
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+typename SegmentedVector<T, Allocator, FirstSegmentSize>::const_iterator SegmentedVector<T, Allocator, FirstSegmentSize>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+SegmentedVector<T, Allocator, FirstSegmentSize>::SegmentedVector(const Allocator &alloc) noexcept
+: alloc_(alloc) {
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+SegmentedVector<T, Allocator, FirstSegmentSize>::SegmentedVector(const SegmentedVector &other)
+: alloc_(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc_)) {
+    Reserve(other.size_);
+    try {
+        for (const T &item : other) {
+            EmplaceBack(item);
+        }
+    } catch (...) {
+        Clear();
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+SegmentedVector<T, Allocator, FirstSegmentSize>::SegmentedVector(SegmentedVector &&other) noexcept
+: alloc_(other.alloc_)
+, segments_(std::exchange(other.segments_, {}))
+, num_segments_(std::exchange(other.num_segments_, 0U))
+, size_(std::exchange(other.size_, 0U)) {
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+SegmentedVector<T, Allocator, FirstSegmentSize> &SegmentedVector<T, Allocator, FirstSegmentSize>::operator=(const SegmentedVector &rhs) {
+    if (this != &rhs) {
+        SegmentedVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+SegmentedVector<T, Allocator, FirstSegmentSize> &SegmentedVector<T, Allocator, FirstSegmentSize>::operator=(SegmentedVector &&rhs) noexcept {
+    if (this != &rhs) {
+        SegmentedVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+    }
+    return *this;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+SegmentedVector<T, Allocator, FirstSegmentSize>::~SegmentedVector() {
+    Clear();
+    FreeSegmentsFrom(0U);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::Swap(SegmentedVector &other) noexcept {
+    using std::swap;
+    swap(alloc_, other.alloc_);
+    segments_.swap(other.segments_);
+    std::swap(num_segments_, other.num_segments_);
+    std::swap(size_, other.size_);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::Reserve(const size_t new_capacity) {
+    while (Capacity() < new_capacity) {
+        AddSegment();
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::Resize(const size_t new_size) {
+    if (new_size <= size_) {
+        DestroyFrom(new_size);
+        return;
+    }
+    const size_t old_size = size_;
+    Reserve(new_size);
+    try {
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+    } catch (...) {
+        DestroyFrom(old_size);
+        throw;
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+template <typename Obj>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::PushBack(Obj &&value) {
+    EmplaceBack(std::forward<Obj>(value));
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+template <typename... Args>
+T &SegmentedVector<T, Allocator, FirstSegmentSize>::EmplaceBack(Args &&...args) {
+    if (size_ == Capacity()) {
+        AddSegment();
+    }
+    const typename Layout::Location location = Layout::Locate(size_);
+    T *const slot = segments_[location.segment] + location.offset;
+    new (slot) T(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::PopBack() noexcept {
+    assert(size_ != 0U);
+    DestroyFrom(size_ - 1U);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::Clear() noexcept {
+    DestroyFrom(0U);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::ShrinkToFit() noexcept {
+    FreeSegmentsFrom((size_ == 0U) ? 0U : Layout::Locate(size_ - 1U).segment + 1U);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+size_t SegmentedVector<T, Allocator, FirstSegmentSize>::Size() const noexcept {
+    return size_;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+size_t SegmentedVector<T, Allocator, FirstSegmentSize>::Capacity() const noexcept {
+    return Layout::Start(num_segments_);
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+T &SegmentedVector<T, Allocator, FirstSegmentSize>::operator[](const size_t index) noexcept {
+    assert(index < size_);
+    const typename Layout::Location location = Layout::Locate(index);
+    return segments_[location.segment][location.offset];
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+const T &SegmentedVector<T, Allocator, FirstSegmentSize>::operator[](const size_t index) const noexcept {
+    return const_cast<SegmentedVector &>(*this)[index];
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+Allocator SegmentedVector<T, Allocator, FirstSegmentSize>::GetAllocator() const noexcept {
+    return alloc_;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::AddSegment() {
+    assert(num_segments_ < Layout::MAX_SEGMENTS);
+    segments_[num_segments_] = AllocTraits::allocate(alloc_, Layout::Capacity(num_segments_));
+    ++num_segments_;
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::FreeSegmentsFrom(const size_t first_segment) noexcept {
+    while (num_segments_ > first_segment) {
+        --num_segments_;
+        AllocTraits::deallocate(alloc_, std::exchange(segments_[num_segments_], nullptr),
+                                Layout::Capacity(num_segments_));
+    }
+}
+
+template <typename T, typename Allocator, size_t FirstSegmentSize>
+void SegmentedVector<T, Allocator, FirstSegmentSize>::DestroyFrom(const size_t new_size) noexcept {
+    std::destroy(begin() + static_cast<std::ptrdiff_t>(new_size), end());
+    size_ = new_size;
+}
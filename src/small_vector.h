@@ -0,0 +1,552 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Вектор с встроенным хранилищем на N элементов.
+ * @details Интерфейс и гарантии безопасности исключений совпадают с Vector. Пока элементов
+ * не больше N, они хранятся внутри самого объекта и куча не используется. При переполнении
+ * элементы переносятся в RawMemory, выделенную аллокатором, и дальше вектор растёт как обычный
+ * Vector. Перемещение вектора со встроенным хранилищем перемещает элементы поэлементно.
+ * Свойства аллокатора propagate_on_container_* учитываются так же, как в Vector, а вставка
+ * и удаление элементов используют общий с Vector код из relocation.h.
+ * @tparam T Тип элемента вектора.
+ * @tparam N Вместимость встроенного хранилища.
+ * @tparam Allocator Тип аллокатора для памяти в куче.
+ * @tparam GrowthPolicy Стратегия роста вместимости.
+ */
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class SmallVector {
+public:
+    using allocator_type = Allocator; //!< Тип аллокатора.
+    using iterator = T *; //!< Итератор.
+    using const_iterator = const T *; //!< Константный итератор.
+
+    static_assert(N > 0U, "Use Vector for SmallVector without inline storage");
+
+    /**
+     * @brief Получить итератор на начало вектора.
+     * @return итератор на начало вектора.
+     */
+    iterator begin() noexcept;
+
+    //! @overload SmallVector::begin()
+    const_iterator begin() const noexcept;
+
+    //! @overload SmallVector::begin()
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Получить итератор на конец вектора.
+     * @return итератор на конец вектора.
+     */
+    iterator end() noexcept;
+
+    //! @overload SmallVector::end()
+    const_iterator end() const noexcept;
+
+    //! @overload SmallVector::end()
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Конструирует пустой вектор.
+     */
+    SmallVector() = default;
+
+    /**
+     * @brief Конструирует пустой вектор с указанным аллокатором.
+     * @param alloc Аллокатор.
+     */
+    explicit SmallVector(const Allocator &alloc) noexcept;
+
+    /**
+     * @brief Конструирует вектор с указанным количеством элементов.
+     * @param size Количество элементов.
+     * @param alloc Аллокатор.
+     */
+    explicit SmallVector(size_t size, const Allocator &alloc = Allocator());
+
+    /**
+     * @brief Деструктор.
+     */
+    ~SmallVector();
+
+    /**
+     * @brief Конструирует объект, копируя переданный.
+     * @param other Объект для копирования.
+     */
+    SmallVector(const SmallVector &other);
+
+    /**
+     * @brief Конструирует объект, копируя переданный, с указанным аллокатором.
+     * @param other Объект для копирования.
+     * @param alloc Аллокатор.
+     */
+    SmallVector(const SmallVector &other, const Allocator &alloc);
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @details Память в куче забирается целиком, встроенные элементы перемещаются поэлементно.
+     * @param other Объект для перемещения.
+     */
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /**
+     * @brief Присваивает объект, копируя себе содержимое переданного.
+     * @param rhs Объект для копирования.
+     * @return текущий объект.
+     */
+    SmallVector &operator=(const SmallVector &rhs);
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @details Если аллокатор не распространяется при перемещении и аллокаторы не равны,
+     * то элементы перемещаются поэлементно в память, выделенную своим аллокатором.
+     * @param rhs Объект для перемещения.
+     * @return текущий объект.
+     */
+    SmallVector &operator=(SmallVector &&rhs) noexcept(
+        std::is_nothrow_move_constructible_v<T>
+        && (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value));
+
+    /**
+     * @brief Меняет местами содержимое текущего объекта с содержимым переданного.
+     * @details Как и для Vector, при propagate_on_container_swap == false аллокаторы должны быть равны.
+     * @param other Объект, с которым нужно поменяться содержимым.
+     */
+    void Swap(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /**
+     * @brief Резервирует место под указанное количество элементов.
+     * @param new_capacity Новая вместимость вектора.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Меняет размер вектора на указанный.
+     * @param new_size Новый размер вектора.
+     */
+    void Resize(size_t new_size);
+
+    /**
+     * @brief Вставить объект в конец вектора.
+     * @tparam Obj Тип объекта для вставки.
+     * @param value Объект для вставки.
+     */
+    template <typename Obj>
+    void PushBack(Obj &&value);
+
+    /**
+     * @brief Удаляет последний элемент.
+     */
+    void PopBack() noexcept;
+
+    /**
+     * @brief Конструирует и вставляет объект в конец вектора.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param args Аргументы для конструирования объекта.
+     * @return возвращает ссылку на сконструированный объект.
+     */
+    template <typename... Args>
+    T &EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Вставляет объект в вектор перед указанным элементом.
+     * @tparam Obj Тип объекта.
+     * @param pos Позиция вставки.
+     * @param value Объект для вставки.
+     * @return итератор на вставленный элемент.
+     */
+    template <typename Obj>
+    iterator Insert(const_iterator pos, Obj &&value);
+
+    /**
+     * @brief Конструирует и вставляет объект в вектор перед указанным элементом.
+     * @tparam Args Типы аргументов для конструирования.
+     * @param pos Позиция вставки.
+     * @param args Аргументы для конструирования.
+     * @return итератор на вставленный элемент.
+     */
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, Args &&...args);
+
+    /**
+     * @brief Стирает элементом в указанной позиции.
+     * @param pos Позиция элемента для стирания.
+     * @return итератор на элемент стоящий после стираемого.
+     */
+    iterator Erase(const_iterator pos);
+
+    /**
+     * @brief Получает размер.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Получает вместимость.
+     * @return вместимость.
+     */
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /**
+     * @brief Проверяет, хранятся ли элементы во встроенном хранилище.
+     * @return true, если память в куче не используется.
+     */
+    [[nodiscard]] bool IsInline() const noexcept;
+
+    /**
+     * @brief Получает доступ к элементу по индексу.
+     * @param index Индекс элемента.
+     * @return ссылку на элемент.
+     */
+    T &operator[](size_t index) noexcept;
+
+    //! @overload SmallVector::operator[](size_t index)
+    const T &operator[](size_t index) const noexcept;
+
+    /**
+     * @brief Получает аллокатор.
+     * @return копию аллокатора.
+     */
+    [[nodiscard]] Allocator GetAllocator() const noexcept;
+
+private:
+    using AllocTraits = std::allocator_traits<Allocator>; //!< Свойства аллокатора.
+
+    alignas(T) std::byte inline_storage_[N * sizeof(T)]; //!< Встроенное хранилище.
+    RawMemory<T, Allocator> heap_; //!< Память в куче, пустая пока элементы встроены.
+    size_t size_ = 0U; //!< Размер.
+
+    /**
+     * @brief Получает адрес начала используемого хранилища.
+     * @return адрес первого элемента.
+     */
+    T *Data() noexcept;
+
+    //! @overload SmallVector::Data()
+    const T *Data() const noexcept;
+
+    /**
+     * @brief Переносит элементы в новую память в куче.
+     * @details Даёт строгую гарантию безопасности.
+     * @param new_capacity Новая вместимость.
+     */
+    void Grow(size_t new_capacity);
+
+    /**
+     * @brief Забирает содержимое другого вектора, сам не имея элементов.
+     * @details Память в куче забирается целиком вместе с аллокатором, встроенные элементы
+     * релоцируются в своё хранилище, которого на них всегда хватает.
+     * @param other Вектор, остающийся пустым.
+     */
+    void StealFrom(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+    /**
+     * @brief Вычисляет вместимость для роста при добавлении одного элемента.
+     * @return новую вместимость по стратегии GrowthPolicy.
+     */
+    [[nodiscard]] size_t NextCapacity() const noexcept;
+};
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() noexcept {
+    return Data();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::end() noexcept {
+    return Data() + size_;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::cbegin() const noexcept {
+    return Data();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::cend() const noexcept {
+    return Data() + size_;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() const noexcept {
+    return cbegin();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::const_iterator SmallVector<T, N, Allocator, GrowthPolicy>::end() const noexcept {
+    return cend();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const Allocator &alloc) noexcept
+: heap_(alloc) {
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const size_t size, const Allocator &alloc)
+: heap_((size > N) ? size : 0U, alloc) {
+    std::uninitialized_value_construct_n(Data(), size);
+    size_ = size;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector &other)
+: SmallVector(other, AllocTraits::select_on_container_copy_construction(other.heap_.GetAllocator())) {
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector &other, const Allocator &alloc)
+: heap_((other.size_ > N) ? other.size_ : 0U, alloc) {
+    std::uninitialized_copy_n(other.Data(), other.size_, Data());
+    size_ = other.size_;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+: heap_(other.heap_.GetAllocator()) {
+    StealFrom(other);
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy> &SmallVector<T, N, Allocator, GrowthPolicy>::operator=(const SmallVector &rhs) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                  && !AllocTraits::is_always_equal::value) {
+        if (heap_.GetAllocator() != rhs.heap_.GetAllocator()) {
+            SmallVector rhs_copy(rhs, rhs.heap_.GetAllocator());
+            Swap(rhs_copy);
+            return *this;
+        }
+    }
+
+    if (rhs.size_ > Capacity()) {
+        SmallVector rhs_copy(rhs, heap_.GetAllocator());
+        Swap(rhs_copy);
+    } else {
+        std::copy_n(rhs.Data(), std::min(size_, rhs.size_), Data());
+        if (size_ < rhs.size_) {
+            std::uninitialized_copy_n(rhs.Data() + size_, rhs.size_ - size_, Data() + size_);
+        } else {
+            std::destroy_n(Data() + rhs.size_, size_ - rhs.size_);
+        }
+        size_ = rhs.size_;
+    }
+    return *this;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy> &SmallVector<T, N, Allocator, GrowthPolicy>::operator=(SmallVector &&rhs) noexcept(
+    std::is_nothrow_move_constructible_v<T>
+    && (AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value)) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    constexpr bool PROPAGATE = AllocTraits::propagate_on_container_move_assignment::value;
+    if (PROPAGATE || AllocTraits::is_always_equal::value || heap_.GetAllocator() == rhs.heap_.GetAllocator()) {
+        std::destroy_n(Data(), size_);
+        size_ = 0U;
+        if constexpr (PROPAGATE) {
+            // Встроенные элементы rhs тоже переходят под его аллокатор
+            heap_ = RawMemory<T, Allocator>(rhs.heap_.GetAllocator());
+        }
+        StealFrom(rhs);
+    } else if (rhs.size_ > Capacity()) {
+        RawMemory<T, Allocator> new_data(rhs.size_, heap_.GetAllocator());
+        std::uninitialized_move_n(rhs.Data(), rhs.size_, new_data.GetAddress());
+        std::destroy_n(Data(), size_);
+        heap_.Swap(new_data);
+        size_ = rhs.size_;
+    } else {
+        // Чужую память забрать нельзя: элементы перемещаются в своё хранилище
+        std::destroy_n(Data(), size_);
+        size_ = 0U;
+        std::uninitialized_move_n(rhs.Data(), rhs.size_, Data());
+        size_ = rhs.size_;
+    }
+    return *this;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::~SmallVector() {
+    std::destroy_n(Data(), size_);
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Swap(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    if (this == &other) {
+        return;
+    }
+    if (!IsInline() && !other.IsInline()) {
+        heap_.Swap(other.heap_);
+        std::swap(size_, other.size_);
+        return;
+    }
+    // Аллокаторы меняются местами вместе с содержимым, даже если оно встроенное
+    SmallVector temp(std::move(other));
+    other.heap_ = RawMemory<T, Allocator>(heap_.GetAllocator());
+    other.StealFrom(*this);
+    heap_ = RawMemory<T, Allocator>(temp.heap_.GetAllocator());
+    StealFrom(temp);
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Reserve(const size_t new_capacity) {
+    if (new_capacity > Capacity() && !heap_.TryExpand(new_capacity)) {
+        Grow(new_capacity);
+    }
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Resize(const size_t new_size) {
+    if (new_size <= size_) {
+        std::destroy_n(Data() + new_size, size_ - new_size);
+    } else {
+        Reserve(new_size);
+        std::uninitialized_value_construct_n(Data() + size_, new_size - size_);
+    }
+    size_ = new_size;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+template<typename Obj>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PushBack(Obj &&value) {
+    EmplaceBack(std::forward<Obj>(value));
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::PopBack() noexcept {
+    std::destroy_at(Data() + size_ - 1U);
+    --size_;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+template<typename... Args>
+T &SmallVector<T, N, Allocator, GrowthPolicy>::EmplaceBack(Args &&...args) {
+    if (size_ == Capacity() && !heap_.TryExpand(NextCapacity())) {
+        RawMemory<T, Allocator> new_data(NextCapacity(), heap_.GetAllocator());
+        RelocateEmplacing(Data(), size_, size_, new_data.GetAddress(), std::forward<Args>(args)...);
+        heap_.Swap(new_data);
+    } else {
+        new (Data() + size_) T(std::forward<Args>(args)...);
+    }
+    ++size_;
+    return Data()[size_ - 1U];
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+template<typename Obj>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Insert(const const_iterator pos, Obj &&value) {
+    return Emplace(pos, std::forward<Obj>(value));
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+template<typename... Args>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Emplace(const const_iterator pos, Args &&...args) {
+    const size_t dist = pos - cbegin();
+    if (size_ == dist) {
+        EmplaceBack(std::forward<Args>(args)...);
+        return Data() + dist;
+    }
+
+    if (size_ < Capacity() || heap_.TryExpand(NextCapacity())) {
+        EmplaceShifting(Data(), size_, dist, std::forward<Args>(args)...);
+    } else {
+        RawMemory<T, Allocator> new_data(NextCapacity(), heap_.GetAllocator());
+        RelocateEmplacing(Data(), size_, dist, new_data.GetAddress(), std::forward<Args>(args)...);
+        heap_.Swap(new_data);
+    }
+    ++size_;
+    return Data() + dist;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+typename SmallVector<T, N, Allocator, GrowthPolicy>::iterator SmallVector<T, N, Allocator, GrowthPolicy>::Erase(const const_iterator pos) {
+    const size_t dist = pos - cbegin();
+    EraseShifting(Data(), size_, dist);
+    --size_;
+    return Data() + dist;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+size_t SmallVector<T, N, Allocator, GrowthPolicy>::Size() const noexcept {
+    return size_;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+size_t SmallVector<T, N, Allocator, GrowthPolicy>::Capacity() const noexcept {
+    return IsInline() ? N : heap_.Capacity();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+bool SmallVector<T, N, Allocator, GrowthPolicy>::IsInline() const noexcept {
+    return heap_.GetAddress() == nullptr;
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+const T &SmallVector<T, N, Allocator, GrowthPolicy>::operator[](const size_t index) const noexcept {
+    return const_cast<SmallVector &>(*this)[index];
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+T &SmallVector<T, N, Allocator, GrowthPolicy>::operator[](const size_t index) noexcept {
+    assert(index < size_);
+    return Data()[index];
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+Allocator SmallVector<T, N, Allocator, GrowthPolicy>::GetAllocator() const noexcept {
+    return heap_.GetAllocator();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+T *SmallVector<T, N, Allocator, GrowthPolicy>::Data() noexcept {
+    return IsInline() ? std::launder(reinterpret_cast<T *>(inline_storage_)) : heap_.GetAddress();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+const T *SmallVector<T, N, Allocator, GrowthPolicy>::Data() const noexcept {
+    return const_cast<SmallVector &>(*this).Data();
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::Grow(const size_t new_capacity) {
+    RawMemory<T, Allocator> new_data(new_capacity, heap_.GetAllocator());
+    UninitializedRelocate(Data(), size_, new_data.GetAddress());
+    DestroyRelocated(Data(), size_);
+    heap_.Swap(new_data);
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+size_t SmallVector<T, N, Allocator, GrowthPolicy>::NextCapacity() const noexcept {
+    return GrowthPolicy::NextCapacity(Capacity(), size_ + 1U, sizeof(T));
+}
+
+template<typename T, size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::StealFrom(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+    assert(size_ == 0U);
+    if (!other.IsInline()) {
+        heap_ = std::move(other.heap_);
+    } else if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        RelocateBitwise(other.Data(), other.size_, Data());
+    } else {
+        std::uninitialized_move_n(other.Data(), other.size_, Data());
+        std::destroy_n(other.Data(), other.size_);
+    }
+    size_ = std::exchange(other.size_, 0U);
+}
@@ -0,0 +1,701 @@
+#pragma once
+
+#include "growth_policy.h"
+#include "raw_memory.h"
+#include "relocation.h"
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief Вектор записей, хранящий каждое поле в отдельном столбце.
+ * @details Запись из полей Fields... раскладывается по столбцам: i-е поле всех записей
+ * лежит подряд в своей RawMemory. Проход по одному полю через Column читает память
+ * с единичным шагом и векторизуется, а не тащит через кэш записи целиком. Все столбцы
+ * имеют общие размер и вместимость и меняются синхронно. Доступ к записи возвращает
+ * прокси-ссылку std::tuple<Fields&...>, через которую запись можно читать, присваивать
+ * и разбирать структурным связыванием. EmplaceBack и Reserve дают строгую гарантию
+ * безопасности исключений, поэтому поле, которое нельзя скопировать, должно перемещаться
+ * без исключений: иначе столбец при росте нельзя перенести, не испортив исходный.
+ * @tparam Fields Типы полей записи.
+ */
+template <typename... Fields>
+class SoAVector {
+public:
+    static_assert(sizeof...(Fields) > 0U, "SoAVector needs at least one field");
+
+    using value_type = std::tuple<Fields...>; //!< Тип записи.
+    using reference = std::tuple<Fields &...>; //!< Прокси-ссылка на запись.
+    using const_reference = std::tuple<const Fields &...>; //!< Константная прокси-ссылка на запись.
+
+    //! Количество полей.
+    static constexpr size_t NUM_FIELDS = sizeof...(Fields);
+
+    //! Тип I-го поля.
+    template <size_t I>
+    using Field = std::tuple_element_t<I, value_type>;
+
+    /**
+     * @brief Итератор по записям.
+     * @details Хранит вектор и индекс записи, разыменование возвращает прокси-ссылку.
+     * @tparam IsConst Константный ли итератор.
+     */
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using Owner = std::conditional_t<IsConst, const SoAVector, SoAVector>; //!< Тип вектора.
+        using iterator_category = std::random_access_iterator_tag; //!< Категория итератора.
+        using value_type = SoAVector::value_type; //!< Тип записи.
+        using difference_type = std::ptrdiff_t; //!< Тип расстояния.
+        using pointer = void; //!< Указателя на прокси-ссылку нет.
+        using reference = std::conditional_t<IsConst, const_reference, SoAVector::reference>; //!< Тип ссылки.
+
+        Iterator() noexcept = default;
+
+        //! Конструирует итератор на запись index вектора owner.
+        Iterator(Owner *owner, const size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        //! Неконстантный итератор преобразуется в константный.
+        operator Iterator<true>() const noexcept {  // NOLINT
+            return Iterator<true>(owner_, index_);
+        }
+
+        //! Получает индекс записи.
+        [[nodiscard]] size_t Index() const noexcept {
+            return index_;
+        }
+
+        //! Получает прокси-ссылку на запись.
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        //! Получает прокси-ссылку на запись со смещением.
+        reference operator[](const difference_type offset) const noexcept {
+            return (*owner_)[index_ + offset];
+        }
+
+        //! Переходит к следующей записи.
+        Iterator &operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        //! Переходит к следующей записи.
+        Iterator operator++(int) noexcept {
+            Iterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        //! Переходит к предыдущей записи.
+        Iterator &operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        //! Переходит к предыдущей записи.
+        Iterator operator--(int) noexcept {
+            Iterator old = *this;
+            --index_;
+            return old;
+        }
+
+        //! Сдвигает итератор.
+        Iterator &operator+=(const difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        //! Сдвигает итератор назад.
+        Iterator &operator-=(const difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        //! Получает сдвинутый итератор.
+        friend Iterator operator+(Iterator it, const difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        //! Получает сдвинутый итератор.
+        friend Iterator operator+(const difference_type offset, Iterator it) noexcept {
+            return it += offset;
+        }
+
+        //! Получает сдвинутый назад итератор.
+        friend Iterator operator-(Iterator it, const difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        //! Получает расстояние между итераторами.
+        friend difference_type operator-(const Iterator &lhs, const Iterator &rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        //! Сравнивает итераторы одного вектора.
+        bool operator==(const Iterator &other) const noexcept {
+            return index_ == other.index_;
+        }
+
+        //! Упорядочивает итераторы одного вектора.
+        std::strong_ordering operator<=>(const Iterator &other) const noexcept {
+            return index_ <=> other.index_;
+        }
+
+    private:
+        Owner *owner_ = nullptr; //!< Вектор.
+        size_t index_ = 0U; //!< Индекс записи.
+    };
+
+    using iterator = Iterator<false>; //!< Итератор.
+    using const_iterator = Iterator<true>; //!< Константный итератор.
+
+    /**
+     * @brief Получить итератор на начало вектора.
+     * @return итератор на начало вектора.
+     */
+    iterator begin() noexcept;
+
+    //! @overload SoAVector::begin()
+    const_iterator begin() const noexcept;
+
+    //! @overload SoAVector::begin()
+    const_iterator cbegin() const noexcept;
+
+    /**
+     * @brief Получить итератор на конец вектора.
+     * @return итератор на конец вектора.
+     */
+    iterator end() noexcept;
+
+    //! @overload SoAVector::end()
+    const_iterator end() const noexcept;
+
+    //! @overload SoAVector::end()
+    const_iterator cend() const noexcept;
+
+    /**
+     * @brief Конструирует пустой вектор.
+     */
+    SoAVector() = default;
+
+    /**
+     * @brief Конструирует вектор с указанным количеством записей, поля которых
+     * инициализированы значением.
+     * @param size Количество записей.
+     */
+    explicit SoAVector(size_t size);
+
+    /**
+     * @brief Конструирует объект, копируя переданный.
+     * @param other Объект для копирования.
+     */
+    SoAVector(const SoAVector &other);
+
+    /**
+     * @brief Конструирует объект, перемещая себе содержимое переданного.
+     * @param other Объект для перемещения.
+     */
+    SoAVector(SoAVector &&other) noexcept;
+
+    /**
+     * @brief Присваивает объект, копируя себе содержимое переданного.
+     * @param rhs Объект для копирования.
+     * @return текущий объект.
+     */
+    SoAVector &operator=(const SoAVector &rhs);
+
+    /**
+     * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @details Прежние записи уничтожаются сразу, а не переходят к rhs.
+     * @param rhs Объект для перемещения.
+     * @return текущий объект.
+     */
+    SoAVector &operator=(SoAVector &&rhs) noexcept;
+
+    /**
+     * @brief Деструктор.
+     */
+    ~SoAVector();
+
+    /**
+     * @brief Меняет местами содержимое текущего объекта с содержимым переданного.
+     * @param other Объект, с которым нужно поменяться содержимым.
+     */
+    void Swap(SoAVector &other) noexcept;
+
+    /**
+     * @brief Резервирует место под указанное количество записей во всех столбцах.
+     * @details Даёт строгую гарантию безопасности.
+     * @param new_capacity Новая вместимость вектора.
+     */
+    void Reserve(size_t new_capacity);
+
+    /**
+     * @brief Меняет размер вектора на указанный.
+     * @details Поля новых записей инициализируются значением.
+     * @param new_size Новый размер вектора.
+     */
+    void Resize(size_t new_size);
+
+    /**
+     * @brief Конструирует запись в конце вектора, каждое поле - из своего аргумента.
+     * @details Даёт строгую гарантию безопасности. Аргументы могут ссылаться на поля
+     * записей этого же вектора.
+     * @tparam Args Типы аргументов, по одному на поле.
+     * @param args Аргументы для конструирования полей.
+     * @return прокси-ссылку на сконструированную запись.
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Fields))
+    reference EmplaceBack(Args &&...args);
+
+    /**
+     * @brief Удаляет последнюю запись.
+     */
+    void PopBack() noexcept;
+
+    /**
+     * @brief Стирает запись в указанной позиции.
+     * @param pos Позиция записи для стирания.
+     * @return итератор на запись, стоящую после стираемой.
+     */
+    iterator Erase(const_iterator pos);
+
+    /**
+     * @brief Стирает записи диапазона [first, last).
+     * @details Хвост каждого столбца сдвигается один раз. Если перемещающее присваивание
+     * бросит исключение, ни одна запись не уничтожается и размер не меняется, но часть
+     * записей может остаться перемещённой.
+     * @param first Начало стираемого диапазона.
+     * @param last Конец стираемого диапазона.
+     * @return итератор на запись, стоящую после стёртых.
+     */
+    iterator Erase(const_iterator first, const_iterator last);
+
+    /**
+     * @brief Уничтожает все записи, сохраняя вместимость.
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Получает размер.
+     * @return размер.
+     */
+    [[nodiscard]] size_t Size() const noexcept;
+
+    /**
+     * @brief Получает вместимость.
+     * @return вместимость.
+     */
+    [[nodiscard]] size_t Capacity() const noexcept;
+
+    /**
+     * @brief Получает доступ к записи по индексу.
+     * @param index Индекс записи.
+     * @return прокси-ссылку на запись.
+     */
+    reference operator[](size_t index) noexcept;
+
+    //! @overload SoAVector::operator[](size_t index)
+    const_reference operator[](size_t index) const noexcept;
+
+    /**
+     * @brief Получает столбец I-го поля всех записей.
+     * @tparam I Индекс поля.
+     * @return непрерывный участок из Size() значений поля.
+     */
+    template <size_t I>
+    std::span<Field<I>> Column() noexcept;
+
+    //! @overload SoAVector::Column()
+    template <size_t I>
+    std::span<const Field<I>> Column() const noexcept;
+
+private:
+    using Columns = std::tuple<RawMemory<Fields>...>; //!< Столбцы полей.
+
+    //! Может ли перенос столбца поля в новую память бросить исключение.
+    template <typename F>
+    static constexpr bool RELOCATION_MAY_THROW = !IS_TRIVIALLY_RELOCATABLE<F>
+                                                 && !std::is_nothrow_move_constructible_v<F>
+                                                 && std::is_copy_constructible_v<F>;
+
+    static_assert(((IS_TRIVIALLY_RELOCATABLE<Fields> || std::is_nothrow_move_constructible_v<Fields>
+                    || std::is_copy_constructible_v<Fields>) && ...),
+                  "SoAVector fields must be copyable or nothrow move constructible");
+
+    Columns columns_; //!< Столбцы полей.
+    size_t size_ = 0U; //!< Размер.
+
+    /**
+     * @brief Выделяет столбцы указанной вместимости.
+     * @param capacity Вместимость.
+     * @return столбцы.
+     */
+    static Columns AllocateColumns(size_t capacity);
+
+    /**
+     * @brief Конструирует столбцы по очереди, начиная с I-го.
+     * @details Если конструирование столбца бросит исключение, уже сконструированные
+     * элементы [first, first + n) предыдущих столбцов уничтожаются.
+     * @tparam I Индекс первого столбца.
+     * @tparam Construct Тип функции, которая получает std::integral_constant<size_t, I>,
+     * конструирует элементы столбца и возвращает true, если что-то сконструировала.
+     * @param columns Столбцы.
+     * @param first Индекс первого конструируемого элемента.
+     * @param n Количество конструируемых элементов.
+     * @param construct Функция конструирования.
+     */
+    template <size_t I = 0U, typename Construct>
+    static void ConstructColumns(Columns &columns, size_t first, size_t n, Construct &construct);
+
+    /**
+     * @brief Уничтожает элементы [first, first + n) всех столбцов.
+     * @param columns Столбцы.
+     * @param first Индекс первого элемента.
+     * @param n Количество элементов.
+     */
+    static void DestroyColumns(Columns &columns, size_t first, size_t n) noexcept;
+
+    /**
+     * @brief Переносит записи в новые столбцы.
+     * @details Сначала переносятся столбцы, перенос которых может бросить исключение: при
+     * исключении их копии уничтожаются, а исходные записи остаются нетронутыми. Затем
+     * остальные столбцы переносятся без исключений, и исходные записи уничтожаются.
+     * @param new_columns Новые столбцы вместимостью не меньше размера.
+     */
+    void RelocateTo(Columns &new_columns);
+
+    /**
+     * @brief Сдвигает хвост столбца присваиванием перед стиранием count элементов с индекса dist.
+     * @details Делает только то, что может бросить исключение, и ничего не уничтожает.
+     * Тривиально релоцируемые столбцы сдвигаются позже, в FinishEraseFromColumn.
+     * @param data Начало столбца.
+     * @param size Размер столбца.
+     * @param dist Индекс первого стираемого элемента.
+     * @param count Количество стираемых элементов.
+     */
+    template <typename F>
+    static void ShiftColumnForErase(F *data, size_t size, size_t dist, size_t count);
+
+    /**
+     * @brief Завершает стирание в столбце, когда все столбцы уже сдвинуты.
+     * @details Уничтожает лишние элементы и сдвигает тривиально релоцируемые столбцы.
+     * @param data Начало столбца.
+     * @param size Размер столбца.
+     * @param dist Индекс первого стираемого элемента.
+     * @param count Количество стираемых элементов.
+     */
+    template <typename F>
+    static void FinishEraseFromColumn(F *data, size_t size, size_t dist, size_t count) noexcept;
+
+    /**
+     * @brief Собирает прокси-ссылку на запись.
+     * @param index Индекс записи.
+     * @return прокси-ссылку.
+     */
+    template <size_t... Is>
+    reference Reference(size_t index, std::index_sequence<Is...>) noexcept;
+};
+
+template <typename... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::begin() noexcept {
+    return iterator(this, 0U);
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::begin() const noexcept {
+    return cbegin();
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::cbegin() const noexcept {
+    return const_iterator(this, 0U);
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::end() noexcept {
+    return iterator(this, size_);
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::end() const noexcept {
+    return cend();
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::const_iterator SoAVector<Fields...>::cend() const noexcept {
+    return const_iterator(this, size_);
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(const size_t size)
+: columns_(AllocateColumns(size)) {
+    auto construct = [this, size]<size_t I>(std::integral_constant<size_t, I>) {
+        std::uninitialized_value_construct_n(std::get<I>(columns_).GetAddress(), size);
+        return true;
+    };
+    ConstructColumns(columns_, 0U, size, construct);
+    size_ = size;
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(const SoAVector &other)
+: columns_(AllocateColumns(other.size_)) {
+    auto construct = [this, &other]<size_t I>(std::integral_constant<size_t, I>) {
+        std::uninitialized_copy_n(std::get<I>(other.columns_).GetAddress(), other.size_,
+                                  std::get<I>(columns_).GetAddress());
+        return true;
+    };
+    ConstructColumns(columns_, 0U, other.size_, construct);
+    size_ = other.size_;
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::SoAVector(SoAVector &&other) noexcept
+: columns_(std::move(other.columns_))
+, size_(std::exchange(other.size_, 0U)) {
+}
+
+template <typename... Fields>
+SoAVector<Fields...> &SoAVector<Fields...>::operator=(const SoAVector &rhs) {
+    if (this != &rhs) {
+        SoAVector rhs_copy(rhs);
+        Swap(rhs_copy);
+    }
+    return *this;
+}
+
+template <typename... Fields>
+SoAVector<Fields...> &SoAVector<Fields...>::operator=(SoAVector &&rhs) noexcept {
+    if (this != &rhs) {
+        SoAVector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+    }
+    return *this;
+}
+
+template <typename... Fields>
+SoAVector<Fields...>::~SoAVector() {
+    DestroyColumns(columns_, 0U, size_);
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::Swap(SoAVector &other) noexcept {
+    columns_.swap(other.columns_);
+    std::swap(size_, other.size_);
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::Reserve(const size_t new_capacity) {
+    if (new_capacity <= Capacity()) {
+        return;
+    }
+    Columns new_columns = AllocateColumns(new_capacity);
+    RelocateTo(new_columns);
+    columns_.swap(new_columns);
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::Resize(const size_t new_size) {
+    if (new_size <= size_) {
+        DestroyColumns(columns_, new_size, size_ - new_size);
+    } else {
+        Reserve(new_size);
+        auto construct = [this, new_size]<size_t I>(std::integral_constant<size_t, I>) {
+            std::uninitialized_value_construct_n(std::get<I>(columns_) + size_, new_size - size_);
+            return true;
+        };
+        ConstructColumns(columns_, size_, new_size - size_, construct);
+    }
+    size_ = new_size;
+}
+
+template <typename... Fields>
+template <typename... Args>
+    requires(sizeof...(Args) == sizeof...(Fields))
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::EmplaceBack(Args &&...args) {
+    auto arg_refs = std::forward_as_tuple(std::forward<Args>(args)...);
+    auto construct_in = [this, &arg_refs](Columns &columns) {
+        auto construct = [this, &arg_refs, &columns]<size_t I>(std::integral_constant<size_t, I>) {
+            new (std::get<I>(columns) + size_) Field<I>(std::get<I>(std::move(arg_refs)));
+            return true;
+        };
+        ConstructColumns(columns, size_, 1U, construct);
+    };
+    if (size_ == Capacity()) {
+        // Новая запись конструируется до переноса старых, так как аргументы могут ссылаться на них
+        Columns new_columns = AllocateColumns(DoublingGrowth::NextCapacity(Capacity(), size_ + 1U, 0U));
+        construct_in(new_columns);
+        try {
+            RelocateTo(new_columns);
+        } catch (...) {
+            DestroyColumns(new_columns, size_, 1U);
+            throw;
+        }
+        columns_.swap(new_columns);
+    } else {
+        construct_in(columns_);
+    }
+    ++size_;
+    return (*this)[size_ - 1U];
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::PopBack() noexcept {
+    assert(size_ != 0U);
+    DestroyColumns(columns_, size_ - 1U, 1U);
+    --size_;
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::Erase(const const_iterator pos) {
+    return Erase(pos, pos + 1);
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::iterator SoAVector<Fields...>::Erase(const const_iterator first,
+                                                                     const const_iterator last) {
+    const size_t dist = first.Index();
+    const size_t count = last - first;
+    assert(dist + count <= size_);
+    if (count != 0U) {
+        // Сначала сдвигаются все столбцы, чтобы исключение не оставило часть из них укороченными
+        std::apply([this, dist, count](auto &...columns) {
+            (ShiftColumnForErase(columns.GetAddress(), size_, dist, count), ...);
+            (FinishEraseFromColumn(columns.GetAddress(), size_, dist, count), ...);
+        }, columns_);
+        size_ -= count;
+    }
+    return iterator(this, dist);
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::Clear() noexcept {
+    DestroyColumns(columns_, 0U, size_);
+    size_ = 0U;
+}
+
+template <typename... Fields>
+size_t SoAVector<Fields...>::Size() const noexcept {
+    return size_;
+}
+
+template <typename... Fields>
+size_t SoAVector<Fields...>::Capacity() const noexcept {
+    return std::get<0>(columns_).Capacity();
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::operator[](const size_t index) noexcept {
+    assert(index < size_);
+    return Reference(index, std::index_sequence_for<Fields...>{});
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::const_reference SoAVector<Fields...>::operator[](const size_t index) const noexcept {
+    return const_cast<SoAVector &>(*this)[index];
+}
+
+template <typename... Fields>
+template <size_t I>
+std::span<typename SoAVector<Fields...>::template Field<I>> SoAVector<Fields...>::Column() noexcept {
+    return {std::get<I>(columns_).GetAddress(), size_};
+}
+
+template <typename... Fields>
+template <size_t I>
+std::span<const typename SoAVector<Fields...>::template Field<I>> SoAVector<Fields...>::Column() const noexcept {
+    return {std::get<I>(columns_).GetAddress(), size_};
+}
+
+template <typename... Fields>
+typename SoAVector<Fields...>::Columns SoAVector<Fields...>::AllocateColumns(const size_t capacity) {
+    return Columns(RawMemory<Fields>(capacity)...);
+}
+
+template <typename... Fields>
+template <size_t I, typename Construct>
+void SoAVector<Fields...>::ConstructColumns(Columns &columns, const size_t first, const size_t n, Construct &construct) {
+    if constexpr (I < NUM_FIELDS) {
+        const bool constructed = construct(std::integral_constant<size_t, I>{});
+        try {
+            ConstructColumns<I + 1U>(columns, first, n, construct);
+        } catch (...) {
+            if (constructed) {
+                std::destroy_n(std::get<I>(columns) + first, n);
+            }
+            throw;
+        }
+    }
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::DestroyColumns(Columns &columns, const size_t first, const size_t n) noexcept {
+    std::apply([first, n](auto &...column) {
+        (std::destroy_n(column + first, n), ...);
+    }, columns);
+}
+
+template <typename... Fields>
+void SoAVector<Fields...>::RelocateTo(Columns &new_columns) {
+    auto relocate_throwing = [this, &new_columns]<size_t I>(std::integral_constant<size_t, I>) {
+        if constexpr (RELOCATION_MAY_THROW<Field<I>>) {
+            UninitializedRelocate(std::get<I>(columns_).GetAddress(), size_, std::get<I>(new_columns).GetAddress());
+            return true;
+        } else {
+            return false;
+        }
+    };
+    ConstructColumns(new_columns, 0U, size_, relocate_throwing);
+    auto relocate_rest = [this, &new_columns]<size_t I>(std::integral_constant<size_t, I>) noexcept {
+        if constexpr (!RELOCATION_MAY_THROW<Field<I>>) {
+            UninitializedRelocate(std::get<I>(columns_).GetAddress(), size_, std::get<I>(new_columns).GetAddress());
+        }
+        DestroyRelocated(std::get<I>(columns_).GetAddress(), size_);
+    };
+    [&relocate_rest]<size_t... Is>(std::index_sequence<Is...>) {
+        (relocate_rest(std::integral_constant<size_t, Is>{}), ...);
+    }(std::index_sequence_for<Fields...>{});
+}
+
+template <typename... Fields>
+template <typename F>
+void SoAVector<Fields...>::ShiftColumnForErase(F *const data, const size_t size, const size_t dist,
+                                               const size_t count) {
+    if constexpr (!IS_TRIVIALLY_RELOCATABLE<F>) {
+        std::move(data + (dist + count), data + size, data + dist);
+    }
+}
+
+template <typename... Fields>
+template <typename F>
+void SoAVector<Fields...>::FinishEraseFromColumn(F *const data, const size_t size, const size_t dist,
+                                                 const size_t count) noexcept {
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<F>) {
+        std::destroy_n(data + dist, count);
+        RelocateBitwiseOverlapping(data + (dist + count), size - (dist + count), data + dist);
+    } else {
+        std::destroy_n(data + (size - count), count);
+    }
+}
+
+template <typename... Fields>
+template <size_t... Is>
+typename SoAVector<Fields...>::reference SoAVector<Fields...>::Reference(const size_t index,
+                                                                         std::index_sequence<Is...>) noexcept {
+    return reference(std::get<Is>(columns_)[index]...);
+}
@@ -1,23 +1,112 @@
 #pragma once
 
+#include "growth_policy.h"
 #include "raw_memory.h"
+#include "relocation.h"
+#include "vector_instrumentation.h"
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstddef>
 #include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <new>
+#include <ranges>
+#include <source_location>
 #include <utility>
 
+/**
+ * @brief Итератор по бесконечной последовательности копий одного значения.
+ * @details Нужен, чтобы вставлять count копий значения тем же кодом, что и диапазоны.
+ * @tparam T Тип значения.
+ */
+template <typename T>
+class RepeatIterator {
+public:
+    using iterator_category = std::forward_iterator_tag; //!< Категория итератора.
+    using value_type = T; //!< Тип значения.
+    using difference_type = std::ptrdiff_t; //!< Тип расстояния.
+    using pointer = const T *; //!< Указатель на значение.
+    using reference = const T &; //!< Ссылка на значение.
+
+    RepeatIterator() = default;
+
+    /**
+     * @brief Конструирует итератор на копии значения.
+     * @param value Значение, которое должно пережить итератор.
+     */
+    explicit RepeatIterator(const T &value) noexcept
+    : value_(&value) {
+    }
+
+    //! Получает значение.
+    reference operator*() const noexcept {
+        return *value_;
+    }
+
+    //! Переходит к следующей копии.
+    RepeatIterator &operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    //! @overload RepeatIterator::operator++()
+    RepeatIterator operator++(int) noexcept {
+        RepeatIterator old = *this;
+        ++index_;
+        return old;
+    }
+
+    //! Итераторы равны, если указывают на одну и ту же по счёту копию.
+    bool operator==(const RepeatIterator &other) const noexcept {
+        return index_ == other.index_;
+    }
+
+private:
+    const T *value_ = nullptr; //!< Значение.
+    difference_type index_ = 0; //!< Номер копии.
+};
+
+/**
+ * @brief Метка конструктора и методов, инициализирующих новые элементы по умолчанию.
+ * @details Для тривиально конструируемых по умолчанию типов, например int или double,
+ * это значит, что память не заполняется нулями и элементы остаются неинициализированными.
+ * Так имеет смысл создавать буферы, которые сразу будут перезаписаны, например при чтении.
+ */
+struct DefaultInitTag {};
+
+//! Метка инициализации по умолчанию.
+inline constexpr DefaultInitTag DEFAULT_INIT{};
+
 /**
  * @brief Вектор. Контейнер для элементов типа, указанного в шаблонном параметре.
  * Располагает элементы последовательно в линейном участке памяти. Вместимость
  * вектора может меняться.
+ * @details Память запрашивается через аллокатор по правилам std::allocator_traits, в том
+ * числе с учётом свойств propagate_on_container_* и select_on_container_copy_construction.
+ * Элементы же конструируются и уничтожаются напрямую - размещающим new, алгоритмами
+ * std::uninitialized_* и std::destroy*, а не через allocator_traits::construct и destroy:
+ * иначе были бы невозможны побайтовая релокация, выделение заполненной нулями памяти и
+ * инициализация по умолчанию. Поэтому аллокаторы, которые передают себя элементам
+ * (std::scoped_allocator_adaptor, std::pmr::polymorphic_allocator), управляют только памятью
+ * вектора, а элементы создаются без аллокатора.
  * @tparam T Тип элемента вектора.
+ * @tparam Allocator Тип аллокатора.
+ * @tparam GrowthPolicy Стратегия роста вместимости, в том числе, возможно, её уменьшения
+ * после удаления элементов.
+ * @tparam Instrumentation Получатель событий смены вместимости, по умолчанию выключен.
+ * @see growth_policy.h
+ * @see vector_instrumentation.h
  */
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          typename Instrumentation = NoInstrumentation>
 class Vector {
+    static_assert(VectorInstrumentation<Instrumentation>);
+
 public:
+    using allocator_type = Allocator; //!< Тип аллокатора.
     using iterator = T *; //!< Итератор.
     using const_iterator = const T *; //!< Константный итератор.
 
@@ -52,11 +141,41 @@ public:
      */
     Vector() = default;
 
+    /**
+     * @brief Конструирует пустой вектор с указанным аллокатором.
+     * @param alloc Аллокатор.
+     */
+    explicit Vector(const Allocator& alloc) noexcept;
+
     /**
      * @brief Конструирует вектор с указанным количеством элементов.
+     * @details Если нулевые байты - значение элемента после инициализации значением
+     * (IS_ZERO_INITIALIZABLE), а аллокатор умеет выделять заполненную нулями память,
+     * то элементы не конструируются, а память берётся уже обнулённой.
+     * @param size Количество элементов.
+     * @param alloc Аллокатор.
+     */
+    explicit Vector(size_t size, const Allocator& alloc = Allocator());
+
+    /**
+     * @brief Конструирует вектор с указанным количеством элементов, инициализированных
+     * по умолчанию.
+     * @details Элементы тривиально конструируемых по умолчанию типов не инициализируются.
      * @param size Количество элементов.
+     * @param alloc Аллокатор.
      */
-    explicit Vector(size_t size);
+    Vector(size_t size, DefaultInitTag, const Allocator& alloc = Allocator());
+
+    /**
+     * @brief Конструирует вектор из элементов диапазона [first, last).
+     * @details Для многопроходных итераторов память выделяется один раз.
+     * @tparam InputIt Тип итератора.
+     * @param first Начало диапазона.
+     * @param last Конец диапазона.
+     * @param alloc Аллокатор.
+     */
+    template <std::input_iterator InputIt>
+    Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator());
 
     /**
      * @brief Деструктор.
@@ -70,6 +189,13 @@ public:
      */
     Vector(const Vector &other);
 
+    /**
+     * @brief Конструирует объект, копируя переданный, с указанным аллокатором.
+     * @param other Объект для копирования.
+     * @param alloc Аллокатор.
+     */
+    Vector(const Vector &other, const Allocator& alloc);
+
     /**
      * @brief Конструирует объект, перемещая себе содержимого переданного.
      * @param other Объект для перемещения.
@@ -85,13 +211,20 @@ public:
 
     /**
      * @brief Присваивает объект, перемещая себе содержимое переданного.
+     * @details Прежние элементы и память уничтожаются сразу, а не переходят к rhs.
+     * Если аллокатор не распространяется при перемещении и аллокаторы не равны,
+     * то элементы перемещаются поэлементно в память, выделенную своим аллокатором.
      * @param rhs Объект для перемещения.
      * @return текущий объект.
      */
-    Vector& operator=(Vector&& rhs) noexcept;
+    Vector& operator=(Vector&& rhs) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value
+        || AllocTraits::is_always_equal::value);
 
     /**
      * @brief Меняет местами содержимое текущего объекта с содержимым переданного.
+     * @details Как и для стандартных контейнеров, при
+     * propagate_on_container_swap == false аллокаторы должны быть равны.
      * @param other Объект, с которым нужно поменяться содержимым.
      */
     void Swap(Vector& other) noexcept;
@@ -112,13 +245,45 @@ public:
      */
     void Resize(size_t new_size);
 
+    /**
+     * @brief Уменьшает вместимость до размера, освобождая лишнюю память.
+     * @details Даёт строгую гарантию безопасности. Пустой вектор освобождает память целиком.
+     */
+    void ShrinkToFit();
+
+    /**
+     * @brief Уничтожает все элементы.
+     * @details Вместимость сохраняется, если стратегия роста не уменьшает её.
+     */
+    void Clear() noexcept;
+
+    /**
+     * @brief Меняет размер вектора на указанный, инициализируя новые элементы по умолчанию.
+     * @details В отличие от Resize, новые элементы тривиально конструируемых по умолчанию
+     * типов не обнуляются, а остаются неинициализированными, так что их нужно перезаписать
+     * до чтения.
+     * @param new_size Новый размер вектора.
+     */
+    void ResizeDefaultInit(size_t new_size);
+
     /**
      * @brief Вставить объект в конец вектора.
      * @tparam Obj Тип объекта для вставки.
      * @param value Объект для вставки.
      */
     template <typename Obj>
-    void PushBack(Obj&& value);
+    void PushBack(Obj&& value) requires (!Instrumentation::ENABLED);
+
+    /**
+     * @brief Вставить объект в конец вектора, запомнив место вызова.
+     * @details Есть только у инструментированных векторов.
+     * @tparam Obj Тип объекта для вставки.
+     * @param value Объект для вставки.
+     * @param site Место вызова для инструментирования.
+     */
+    template <typename Obj>
+    void PushBack(Obj&& value, const std::source_location& site = std::source_location::current())
+        requires Instrumentation::ENABLED;
 
     /**
      * @brief Удаляет последний элемент.
@@ -134,6 +299,17 @@ public:
     template <typename ...Args>
     T& EmplaceBack(Args &&...args);
 
+    /**
+     * @brief Конструирует и вставляет объект в конец вектора, сообщая место вызова.
+     * @details Есть только у инструментированных векторов.
+     * @tparam Args Типы аргументов для конструирования объекта.
+     * @param site Место вызова для инструментирования.
+     * @param args Аргументы для конструирования объекта.
+     * @return возвращает ссылку на сконструированный объект.
+     */
+    template <typename ...Args>
+    T& EmplaceBack(CallSite site, Args &&...args) requires Instrumentation::ENABLED;
+
     /**
      * @brief Вставляет объект в вектор перед указанным элементом.
      * @tparam Obj Тип объекта.
@@ -142,7 +318,14 @@ public:
      * @return итератор на вставленный элемент.
      */
     template <typename Obj>
-    iterator Insert(const_iterator pos, Obj&& value);
+    iterator Insert(const_iterator pos, Obj&& value) requires (!Instrumentation::ENABLED);
+
+    //! @brief Вставляет объект перед указанным элементом, запомнив место вызова.
+    //! @details Есть только у инструментированных векторов.
+    template <typename Obj>
+    iterator Insert(const_iterator pos, Obj&& value,
+                    const std::source_location& site = std::source_location::current())
+        requires Instrumentation::ENABLED;
 
     /**
      * @brief Конструирует и вставляет объект в вектор перед указанным элементом.
@@ -154,6 +337,72 @@ public:
     template <typename... Args>
     iterator Emplace(const_iterator pos, Args&&... args);
 
+    /**
+     * @brief Конструирует и вставляет объект перед указанным элементом, сообщая место вызова.
+     * @details Есть только у инструментированных векторов.
+     * @tparam Args Типы аргументов для конструирования.
+     * @param pos Позиция вставки.
+     * @param site Место вызова для инструментирования.
+     * @param args Аргументы для конструирования.
+     * @return итератор на вставленный элемент.
+     */
+    template <typename... Args>
+    iterator Emplace(const_iterator pos, CallSite site, Args&&... args) requires Instrumentation::ENABLED;
+
+    /**
+     * @brief Вставляет элементы диапазона [first, last) перед указанным элементом.
+     * @details Для многопроходных итераторов вектор растёт не более одного раза, а хвост
+     * сдвигается один раз, для тривиально релоцируемых типов - через memmove. Однопроходный
+     * диапазон сначала собирается во временный вектор. Итераторы не должны указывать
+     * на элементы этого вектора.
+     * @tparam InputIt Тип итератора.
+     * @param pos Позиция вставки.
+     * @param first Начало диапазона.
+     * @param last Конец диапазона.
+     * @return итератор на первый вставленный элемент.
+     */
+    template <std::input_iterator InputIt>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) requires (!Instrumentation::ENABLED);
+
+    //! @brief Вставляет элементы диапазона перед указанным элементом, запомнив место вызова.
+    //! @details Есть только у инструментированных векторов.
+    template <std::input_iterator InputIt>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last,
+                    const std::source_location& site = std::source_location::current())
+        requires Instrumentation::ENABLED;
+
+    /**
+     * @brief Вставляет count копий значения перед указанным элементом.
+     * @details Вектор растёт не более одного раза, хвост сдвигается один раз.
+     * @param pos Позиция вставки.
+     * @param count Количество копий.
+     * @param value Значение, может быть элементом этого же вектора.
+     * @return итератор на первый вставленный элемент.
+     */
+    iterator Insert(const_iterator pos, size_t count, const T& value) requires (!Instrumentation::ENABLED);
+
+    //! @brief Вставляет count копий значения перед указанным элементом, запомнив место вызова.
+    //! @details Есть только у инструментированных векторов.
+    iterator Insert(const_iterator pos, size_t count, const T& value,
+                    const std::source_location& site = std::source_location::current())
+        requires Instrumentation::ENABLED;
+
+    /**
+     * @brief Добавляет элементы диапазона в конец вектора.
+     * @details Для многопроходных и знающих свой размер диапазонов вектор растёт не более
+     * одного раза.
+     * @tparam Range Тип диапазона.
+     * @param range Диапазон, не являющийся этим вектором.
+     */
+    template <std::ranges::input_range Range>
+    void Append(Range&& range) requires (!Instrumentation::ENABLED);
+
+    //! @brief Добавляет элементы диапазона в конец вектора, запомнив место вызова.
+    //! @details Есть только у инструментированных векторов.
+    template <std::ranges::input_range Range>
+    void Append(Range&& range, const std::source_location& site = std::source_location::current())
+        requires Instrumentation::ENABLED;
+
     /**
      * @brief Стирает элементом в указанной позиции.
      * @param pos Позиция элемента для стирания.
@@ -161,6 +410,35 @@ public:
      */
     iterator Erase(const_iterator pos);
 
+    /**
+     * @brief Стирает элементы диапазона [first, last).
+     * @details Хвост сдвигается один раз, для тривиально релоцируемых типов - через memmove.
+     * @param first Начало стираемого диапазона.
+     * @param last Конец стираемого диапазона.
+     * @return итератор на элемент, стоящий после стёртых.
+     */
+    iterator Erase(const_iterator first, const_iterator last);
+
+    /**
+     * @brief Стирает все элементы, удовлетворяющие предикату, за один проход.
+     * @details Оставшиеся элементы сохраняют порядок. Если предикат бросит исключение,
+     * вектор останется корректным, но часть элементов может быть уже стёрта.
+     * @tparam Predicate Тип предиката, принимающего константную ссылку на элемент.
+     * @param pred Предикат.
+     * @return количество стёртых элементов.
+     */
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred);
+
+    /**
+     * @brief Стирает элементы с указанными индексами за один проход.
+     * @details Каждый сохраняемый отрезок между стираемыми элементами сдвигается один раз.
+     * @tparam IndexRange Тип диапазона индексов.
+     * @param sorted_indices Строго возрастающие индексы элементов, меньшие Size().
+     */
+    template <std::ranges::input_range IndexRange>
+    void EraseIndices(const IndexRange& sorted_indices);
+
     /**
      * @brief Получает размер.
      * @return размер.
@@ -183,77 +461,230 @@ public:
     //! @overload Vector::operator[](size_t index)
     const T& operator[](size_t index) const noexcept;
 
+    /**
+     * @brief Получает аллокатор.
+     * @return копию аллокатора.
+     */
+    [[nodiscard]] Allocator GetAllocator() const noexcept;
+
 private:
-    RawMemory<T> data_; //!< Выделенная память под объекты.
+    using AllocTraits = std::allocator_traits<Allocator>; //!< Свойства аллокатора.
+
+    //! Можно ли расти через RawMemory::Reallocate, не пересоздавая память.
+    static constexpr bool GROW_IN_PLACE = IS_TRIVIALLY_RELOCATABLE<T>
+                                          && RawMemory<T, Allocator>::CAN_REALLOCATE;
+
+    //! Уменьшает ли стратегия роста вместимость после удаления элементов.
+    static constexpr bool AUTO_SHRINK = ShrinkingGrowthPolicy<GrowthPolicy>;
+
+    //! Можно ли инициализировать элементы значением, выделяя заполненную нулями память.
+    static constexpr bool ZERO_FILLED_ALLOCATION = IS_ZERO_INITIALIZABLE<T>
+                                                   && RawMemory<T, Allocator>::CAN_ALLOCATE_ZEROED;
+
+    RawMemory<T, Allocator> data_; //!< Выделенная память под объекты.
     size_t size_ = 0U; //!< Размер.
 
     /**
-     * @brief Релоцирует элементы из одного участка памяти в другой.
-     * @param from Начало памяти откуда нужно релоцировать.
-     * @param n Количество элементов для релокации.
-     * @param to Начало памяти, в которую нужно релоцировать.
+     * @brief Состояние вектора перед сменой вместимости, нужное для события инструментирования.
+     */
+    struct GrowthProbe {
+        size_t capacity = 0U; //!< Вместимость.
+        size_t size = 0U; //!< Размер.
+        std::chrono::steady_clock::time_point start; //!< Время начала.
+        std::source_location site; //!< Место вызова.
+    };
+
+    /**
+     * @brief Запоминает состояние перед сменой вместимости.
+     * @details При выключенном инструментировании ничего не замеряет.
+     * @param site Место вызова, если оно известно.
+     * @return состояние.
+     */
+    [[nodiscard]] GrowthProbe StartProbe(const std::source_location& site = {}) const noexcept;
+
+    /**
+     * @brief Сообщает инструментированию о смене вместимости.
+     * @param probe Состояние, полученное StartProbe до смены вместимости.
+     * @param kind Событие.
+     * @param relocated true, если вектор сам перенёс элементы в новый буфер. Расширение на месте
+     * и Reallocate аллокатора не считаются: realloc или mremap может обойтись без копирования,
+     * а если и копирует, то вектору об этом не известно.
+     */
+    void FinishProbe(const GrowthProbe &probe, VectorEventKind kind, bool relocated) const noexcept;
+
+    /**
+     * @brief Увеличивает вместимость и сообщает об этом как о событии kind.
+     * @param new_capacity Новая вместимость вектора.
+     * @param kind Событие.
      */
-    void Reallocate(T* from, size_t n, T* to);
+    void ReserveImpl(size_t new_capacity, VectorEventKind kind);
+
+    /**
+     * @brief Переносит элементы в новую заполненную нулями память под new_size элементов.
+     * @details Используется Resize при ZERO_FILLED_ALLOCATION: новые элементы уже равны
+     * нулю, и их не нужно ни конструировать, ни обнулять.
+     * @param new_size Новые размер и вместимость вектора.
+     */
+    void ResizeZeroFilled(size_t new_size);
+
+    /**
+     * @brief Уменьшает вместимость до указанной, не меньшей размера.
+     * @details Даёт строгую гарантию безопасности.
+     * @param new_capacity Новая вместимость вектора.
+     */
+    void ShrinkImpl(size_t new_capacity);
+
+    /**
+     * @brief Уменьшает вместимость, если этого требует стратегия роста.
+     * @details Если перенос элементов не удался, вместимость просто остаётся прежней.
+     */
+    void MaybeShrink() noexcept;
+
+    //! Общая реализация EmplaceBack.
+    template <typename... Args>
+    T& EmplaceBackImpl(const std::source_location& site, Args&&... args);
+
+    //! Общая реализация Emplace.
+    template <typename... Args>
+    iterator EmplaceImpl(const_iterator pos, const std::source_location& site, Args&&... args);
+
+    //! Общая реализация вставки диапазона [first, last).
+    template <std::input_iterator InputIt>
+    iterator InsertRangeImpl(const_iterator pos, InputIt first, InputIt last, const std::source_location& site);
+
+    //! Общая реализация вставки count копий значения.
+    iterator InsertCopiesImpl(const_iterator pos, size_t count, const T& value, const std::source_location& site);
+
+    //! Общая реализация Append.
+    template <std::ranges::input_range Range>
+    void AppendImpl(Range&& range, const std::source_location& site);
+
+    /**
+     * @brief Вычисляет вместимость для роста при добавлении одного элемента.
+     * @return новую вместимость по стратегии GrowthPolicy.
+     */
+    [[nodiscard]] size_t NextCapacity() const noexcept;
+
+    /**
+     * @brief Вычисляет вместимость для роста до указанного количества элементов.
+     * @param required Требуемое количество элементов.
+     * @return новую вместимость по стратегии GrowthPolicy.
+     */
+    [[nodiscard]] size_t GrowthCapacity(size_t required) const noexcept;
+
+    /**
+     * @brief Вставляет count элементов, начиная с first, перед элементом с индексом dist.
+     * @details Вектор растёт не более одного раза, хвост сдвигается один раз.
+     * @tparam ForwardIt Тип итератора, по которому можно пройти дважды: многопроходный
+     * итератор или std::move_iterator поверх него.
+     * @param dist Индекс позиции вставки.
+     * @param first Начало вставляемых элементов.
+     * @param count Количество вставляемых элементов.
+     * @param site Место вызова для инструментирования.
+     * @return итератор на первый вставленный элемент.
+     */
+    template <std::input_iterator ForwardIt>
+    iterator InsertForward(size_t dist, ForwardIt first, size_t count, const std::source_location& site);
 };
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::begin() noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::begin() noexcept {
     return data_.GetAddress();
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::end() noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::end() noexcept {
     return data_ + size_;
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::cbegin() const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::const_iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::cbegin() const noexcept {
     return data_.GetAddress();
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::cend() const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::const_iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::cend() const noexcept {
     return data_ + size_;
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::begin() const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::const_iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::begin() const noexcept {
     return cbegin();
 }
 
-template<typename T>
-typename Vector<T>::const_iterator Vector<T>::end() const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::const_iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::end() const noexcept {
     return cend();
 }
-template<typename T>
-Vector<T>::Vector(const size_t size)
-: data_(size)
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(const Allocator& alloc) noexcept
+: data_(alloc) {
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(const size_t size, const Allocator& alloc)
+: data_(ZERO_FILLED_ALLOCATION ? RawMemory<T, Allocator>(size, ZERO_FILLED, alloc) : RawMemory<T, Allocator>(size, alloc))
+, size_(size) {
+    if constexpr (!ZERO_FILLED_ALLOCATION) {
+        std::uninitialized_value_construct_n(data_.GetAddress(), size);
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(const size_t size, DefaultInitTag /*tag*/, const Allocator& alloc)
+: data_(size, alloc)
 , size_(size) {
-    std::uninitialized_value_construct_n(data_.GetAddress(), size);
+    std::uninitialized_default_construct_n(data_.GetAddress(), size);
 }
 
-template<typename T>
-Vector<T>::Vector(const Vector& other)
-: data_(other.size_)
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template<std::input_iterator InputIt>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(InputIt first, InputIt last, const Allocator& alloc)
+: Vector(alloc) {
+    if constexpr (std::forward_iterator<InputIt>) {
+        InsertForward(0U, first, static_cast<size_t>(std::distance(first, last)), std::source_location{});
+    } else {
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(const Vector& other)
+: Vector(other, AllocTraits::select_on_container_copy_construction(other.data_.GetAllocator())) {
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(const Vector& other, const Allocator& alloc)
+: data_(other.size_, alloc)
 , size_(other.size_) {
     std::uninitialized_copy_n(other.data_.GetAddress(), other.size_, data_.GetAddress());
 }
 
-template<typename T>
-Vector<T>::Vector(Vector&& other) noexcept
-: data_()
-, size_(0U) {
-    Swap(other);
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::Vector(Vector&& other) noexcept
+: data_(std::move(other.data_))
+, size_(std::exchange(other.size_, 0U)) {
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(const Vector& rhs) {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>& Vector<T, Allocator, GrowthPolicy, Instrumentation>::operator=(const Vector& rhs) {
     if (this == &rhs) {
         return *this;
     }
 
+    if constexpr (AllocTraits::propagate_on_container_copy_assignment::value
+                  && !AllocTraits::is_always_equal::value) {
+        if (data_.GetAllocator() != rhs.data_.GetAllocator()) {
+            Vector rhs_copy(rhs, rhs.data_.GetAllocator());
+            Swap(rhs_copy);
+            return *this;
+        }
+    }
+
     if (rhs.size_ > data_.Capacity()) {
-        Vector rhs_copy(rhs);
+        Vector rhs_copy(rhs, data_.GetAllocator());
         Swap(rhs_copy);
     } else {
         std::copy_n(rhs.data_.GetAddress(), std::min(size_, rhs.size_), data_.GetAddress());
@@ -267,73 +698,153 @@ Vector<T>& Vector<T>::operator=(const Vector& rhs) {
     return *this;
 }
 
-template<typename T>
-Vector<T>& Vector<T>::operator=(Vector&& rhs) noexcept {
-    if (this != &rhs) {
-        Swap(rhs);
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>& Vector<T, Allocator, GrowthPolicy, Instrumentation>::operator=(Vector&& rhs) noexcept(
+    AllocTraits::propagate_on_container_move_assignment::value
+    || AllocTraits::is_always_equal::value) {
+    if (this == &rhs) {
+        return *this;
+    }
+
+    if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                  || AllocTraits::is_always_equal::value) {
+        // Прежнее содержимое уничтожается вместе с временным объектом, а не остаётся в rhs
+        Vector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+    } else if (data_.GetAllocator() == rhs.data_.GetAllocator()) {
+        Vector rhs_moved(std::move(rhs));
+        Swap(rhs_moved);
+    } else {
+        RawMemory<T, Allocator> new_data(rhs.size_, data_.GetAllocator());
+        std::uninitialized_move_n(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+        size_ = rhs.size_;
     }
     return *this;
 }
 
-template<typename T>
-Vector<T>::~Vector() {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::~Vector() {
     std::destroy_n(data_.GetAddress(), size_);
+    if constexpr (Instrumentation::ENABLED) {
+        if (data_.Capacity() != 0U) {
+            Instrumentation::OnEvent(VectorEvent{VectorEventKind::DESTROY, this, sizeof(T), data_.Capacity(), 0U, 0U,
+                                                 std::chrono::nanoseconds::zero(), std::source_location{}});
+        }
+    }
 }
 
-template<typename T>
-void Vector<T>::Swap(Vector& other) noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::Swap(Vector& other) noexcept {
     data_.Swap(other.data_);
     std::swap(size_, other.size_);
 }
 
-template<typename T>
-void Vector<T>::Reserve(const size_t new_capacity) {
-    if (new_capacity <= data_.Capacity()) {
-        return;
-    }
-    RawMemory<T> new_data(new_capacity);
-    Reallocate(data_.GetAddress(), size_, new_data.GetAddress());
-    std::destroy_n(data_.GetAddress(), size_);
-    data_.Swap(new_data);
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::Reserve(const size_t new_capacity) {
+    ReserveImpl(new_capacity, VectorEventKind::RESERVE);
 }
 
-template<typename T>
-void Vector<T>::Resize(const size_t new_size) {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::Resize(const size_t new_size) {
     if (new_size <= size_) {
         std::destroy_n(data_ + new_size, size_ - new_size);
+        size_ = new_size;
+        MaybeShrink();
+        return;
+    }
+    if (ZERO_FILLED_ALLOCATION && new_size > data_.Capacity() && size_ <= new_size - size_) {
+        // Новых элементов не меньше, чем старых: скопировать старые дешевле, чем обнулить новые
+        ResizeZeroFilled(new_size);
     } else {
-        Reserve(new_size);
+        ReserveImpl(new_size, VectorEventKind::RESIZE);
         std::uninitialized_value_construct_n(data_ + size_, new_size - size_);
     }
     size_ = new_size;
 }
 
-template<typename T>
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::ResizeDefaultInit(const size_t new_size) {
+    if (new_size <= size_) {
+        std::destroy_n(data_ + new_size, size_ - new_size);
+        size_ = new_size;
+        MaybeShrink();
+        return;
+    }
+    ReserveImpl(new_size, VectorEventKind::RESIZE);
+    std::uninitialized_default_construct_n(data_ + size_, new_size - size_);
+    size_ = new_size;
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template<typename Obj>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::PushBack(Obj&& value) requires (!Instrumentation::ENABLED) {
+    EmplaceBackImpl(std::source_location{}, std::forward<Obj>(value));
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
 template<typename Obj>
-void Vector<T>::PushBack(Obj&& value) {
-    EmplaceBack(std::forward<Obj>(value));
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::PushBack(Obj&& value, const std::source_location& site) requires Instrumentation::ENABLED {
+    EmplaceBackImpl(site, std::forward<Obj>(value));
 }
 
-template<typename T>
-void Vector<T>::PopBack() noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::PopBack() noexcept {
     std::destroy_at(data_ + size_ - 1U);
     --size_;
+    MaybeShrink();
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::ShrinkToFit() {
+    ShrinkImpl(size_);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::Clear() noexcept {
+    std::destroy_n(data_.GetAddress(), size_);
+    size_ = 0U;
+    MaybeShrink();
+}
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <typename... Args>
+T& Vector<T, Allocator, GrowthPolicy, Instrumentation>::EmplaceBack(Args&&... args) {
+    return EmplaceBackImpl(std::source_location{}, std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <typename... Args>
+T& Vector<T, Allocator, GrowthPolicy, Instrumentation>::EmplaceBack(const CallSite site, Args&&... args) requires Instrumentation::ENABLED {
+    return EmplaceBackImpl(site.location, std::forward<Args>(args)...);
 }
-template<typename T>
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
 template <typename... Args>
-T& Vector<T>::EmplaceBack(Args&&... args) {
+T& Vector<T, Allocator, GrowthPolicy, Instrumentation>::EmplaceBackImpl(const std::source_location& site, Args&&... args) {
     if (size_ == Capacity()) {
-        const size_t new_capacity = (size_ == 0U) ? 1U : (size_ * 2U);
-        RawMemory<T> new_data(new_capacity);
-        new (new_data + size_) T(std::forward<Args>(args)...);
-        try {
-            Reallocate(data_.GetAddress(), size_, new_data.GetAddress());
-        } catch (...) {
-            std::destroy_at(new_data + size_);
-            throw;
+        const GrowthProbe probe = StartProbe(site);
+        bool relocated = false;
+        if (data_.TryExpand(NextCapacity())) {
+            new (data_ + size_) T(std::forward<Args>(args)...);
+        } else if constexpr (GROW_IN_PLACE) {
+            // Аргументы могут ссылаться на элементы вектора, поэтому объект создаётся до роста
+            alignas(T) std::byte temp_storage[sizeof(T)];
+            T* temp = new (temp_storage) T(std::forward<Args>(args)...);
+            try {
+                data_.Reallocate(NextCapacity());
+            } catch (...) {
+                std::destroy_at(temp);
+                throw;
+            }
+            RelocateBitwise(temp, 1U, data_ + size_);
+        } else {
+            RawMemory<T, Allocator> new_data(NextCapacity(), data_.GetAllocator());
+            RelocateEmplacing(data_.GetAddress(), size_, size_, new_data.GetAddress(), std::forward<Args>(args)...);
+            data_.Swap(new_data);
+            relocated = true;
         }
-        std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
+        FinishProbe(probe, VectorEventKind::GROW, relocated);
     } else {
         new (data_ + size_) T(std::forward<Args>(args)...);
     }
@@ -341,87 +852,434 @@ T& Vector<T>::EmplaceBack(Args&&... args) {
     return data_[size_ - 1U];
 }
 
-template<typename T>
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <typename Obj>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Insert(const const_iterator pos, Obj&& value) requires (!Instrumentation::ENABLED) {
+    return EmplaceImpl(pos, std::source_location{}, std::forward<Obj>(value));
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
 template <typename Obj>
-typename Vector<T>::iterator Vector<T>::Insert(const const_iterator pos, Obj&& value) {
-    return Emplace(pos, std::forward<Obj>(value));
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Insert(const const_iterator pos, Obj&& value, const std::source_location& site) requires Instrumentation::ENABLED {
+    return EmplaceImpl(pos, site, std::forward<Obj>(value));
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <typename... Args>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Emplace(const const_iterator pos, Args&&... args) {
+    return EmplaceImpl(pos, std::source_location{}, std::forward<Args>(args)...);
 }
 
-template<typename T>
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
 template <typename... Args>
-typename Vector<T>::iterator Vector<T>::Emplace(const const_iterator pos, Args&&... args) {
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Emplace(const const_iterator pos, const CallSite site, Args&&... args) requires Instrumentation::ENABLED {
+    return EmplaceImpl(pos, site.location, std::forward<Args>(args)...);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <typename... Args>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::EmplaceImpl(const const_iterator pos, const std::source_location& site, Args&&... args) {
     const size_t dist = pos - cbegin();
     if (size_ == dist) {
-        EmplaceBack(std::forward<Args>(args)...);
+        EmplaceBackImpl(site, std::forward<Args>(args)...);
         return data_ + dist;
     }
 
-    if (size_ < Capacity()) {
-        T temp(std::forward<Args>(args)...);
-        new (data_ + size_) T(std::move(data_[size_ - 1U]));
-        std::move_backward(data_ + dist, data_ + (size_ - 1U), data_ + size_);
-        data_[dist] = std::move(temp);
-    } else {
-        RawMemory<T> new_data(size_ * 2U);
-        new (new_data + dist) T(std::forward<Args>(args)...);
-        try {
-            Reallocate(data_.GetAddress(), dist, new_data.GetAddress());
-        } catch (...) {
-            std::destroy_at(new_data + dist);
-            throw;
-        }
+    const bool has_room = size_ < Capacity();
+    const GrowthProbe probe = has_room ? GrowthProbe{} : StartProbe(site);
+    bool relocated = false;
+    if (has_room || data_.TryExpand(NextCapacity())) {
+        EmplaceShifting(data_.GetAddress(), size_, dist, std::forward<Args>(args)...);
+    } else if constexpr (GROW_IN_PLACE) {
+        alignas(T) std::byte temp_storage[sizeof(T)];
+        T* temp = new (temp_storage) T(std::forward<Args>(args)...);
         try {
-            Reallocate(data_ + dist, size_ - dist, new_data + (dist + 1U));
+            data_.Reallocate(NextCapacity());
         } catch (...) {
-            std::destroy_n(new_data.GetAddress(), dist + 1U);
+            std::destroy_at(temp);
             throw;
         }
-        std::destroy_n(data_.GetAddress(), size_);
+        RelocateBitwiseOverlapping(data_ + dist, size_ - dist, data_ + (dist + 1U));
+        RelocateBitwise(temp, 1U, data_ + dist);
+    } else {
+        RawMemory<T, Allocator> new_data(NextCapacity(), data_.GetAllocator());
+        RelocateEmplacing(data_.GetAddress(), size_, dist, new_data.GetAddress(), std::forward<Args>(args)...);
         data_.Swap(new_data);
+        relocated = true;
+    }
+    if (!has_room) {
+        FinishProbe(probe, VectorEventKind::GROW, relocated);
     }
     ++size_;
     return data_ + dist;
 }
 
-template<typename T>
-typename Vector<T>::iterator Vector<T>::Erase(const const_iterator pos) {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::input_iterator InputIt>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Insert(const const_iterator pos, InputIt first, InputIt last) requires (!Instrumentation::ENABLED) {
+    return InsertRangeImpl(pos, first, last, std::source_location{});
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::input_iterator InputIt>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Insert(const const_iterator pos, InputIt first, InputIt last, const std::source_location& site) requires Instrumentation::ENABLED {
+    return InsertRangeImpl(pos, first, last, site);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Insert(const const_iterator pos, const size_t count, const T& value) requires (!Instrumentation::ENABLED) {
+    return InsertCopiesImpl(pos, count, value, std::source_location{});
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Insert(const const_iterator pos, const size_t count, const T& value, const std::source_location& site) requires Instrumentation::ENABLED {
+    return InsertCopiesImpl(pos, count, value, site);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::ranges::input_range Range>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::Append(Range&& range) requires (!Instrumentation::ENABLED) {
+    AppendImpl(std::forward<Range>(range), std::source_location{});
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::ranges::input_range Range>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::Append(Range&& range, const std::source_location& site) requires Instrumentation::ENABLED {
+    AppendImpl(std::forward<Range>(range), site);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::input_iterator InputIt>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::InsertRangeImpl(const const_iterator pos, InputIt first, InputIt last, const std::source_location& site) {
     const size_t dist = pos - cbegin();
-    if ((dist + 1U) == size_) {
-        Resize(dist);
+    if constexpr (std::forward_iterator<InputIt>) {
+        return InsertForward(dist, first, static_cast<size_t>(std::distance(first, last)), site);
     } else {
-        std::move(data_ + (dist + 1U), data_ + size_, data_ + dist);
-        std::destroy_at(data_ + (size_ - 1U));
-        --size_;
+        Vector buffer(first, last, data_.GetAllocator());
+        return InsertForward(dist, std::make_move_iterator(buffer.begin()), buffer.Size(), site);
     }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::InsertCopiesImpl(const const_iterator pos, const size_t count, const T& value, const std::source_location& site) {
+    const size_t dist = pos - cbegin();
+    if (count == 0U) {
+        return data_ + dist;
+    }
+    // Значение может оказаться элементом вектора, который сдвинется при вставке
+    const T copy(value);
+    return InsertForward(dist, RepeatIterator<T>(copy), count, site);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::ranges::input_range Range>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::AppendImpl(Range&& range, const std::source_location& site) {
+    if constexpr (std::ranges::forward_range<Range>) {
+        InsertForward(size_, std::ranges::begin(range), static_cast<size_t>(std::ranges::distance(range)), site);
+    } else {
+        if constexpr (std::ranges::sized_range<Range>) {
+            ReserveImpl(size_ + static_cast<size_t>(std::ranges::size(range)), VectorEventKind::GROW);
+        }
+        for (auto&& item : range) {
+            EmplaceBackImpl(site, std::forward<decltype(item)>(item));
+        }
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::input_iterator ForwardIt>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::InsertForward(const size_t dist, ForwardIt first, const size_t count, const std::source_location& site) {
+    if (count == 0U) {
+        return data_ + dist;
+    }
+    const size_t old_size = size_;
+    const size_t new_size = old_size + count;
+    const bool has_room = new_size <= Capacity();
+    const GrowthProbe probe = has_room ? GrowthProbe{} : StartProbe(site);
+    if constexpr (!IS_TRIVIALLY_RELOCATABLE<T>) {
+        if (has_room || data_.TryExpand(GrowthCapacity(new_size))) {
+            // Хвост сдвигается перемещениями: часть в сырую память за концом, часть присваиванием
+            const size_t tail = old_size - dist;
+            if (count <= tail) {
+                std::uninitialized_move_n(data_ + (old_size - count), count, data_ + old_size);
+                size_ = new_size;
+                std::move_backward(data_ + dist, data_ + (old_size - count), data_ + old_size);
+                std::copy_n(first, count, data_ + dist);
+            } else {
+                const ForwardIt middle = std::next(first, static_cast<std::iter_difference_t<ForwardIt>>(tail));
+                std::uninitialized_copy_n(middle, count - tail, data_ + old_size);
+                size_ = old_size + count - tail;
+                std::uninitialized_move_n(data_ + dist, tail, data_ + (dist + count));
+                size_ = new_size;
+                std::copy_n(first, tail, data_ + dist);
+            }
+            if (!has_room) {
+                FinishProbe(probe, VectorEventKind::GROW, false);
+            }
+            return data_ + dist;
+        }
+    }
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        if (has_room || data_.TryExpand(GrowthCapacity(new_size)) || GROW_IN_PLACE) {
+            if constexpr (GROW_IN_PLACE) {
+                if (new_size > Capacity()) {
+                    data_.Reallocate(GrowthCapacity(new_size));
+                }
+            }
+            RelocateBitwiseOverlapping(data_ + dist, old_size - dist, data_ + (dist + count));
+            try {
+                std::uninitialized_copy_n(first, count, data_ + dist);
+            } catch (...) {
+                RelocateBitwiseOverlapping(data_ + (dist + count), old_size - dist, data_ + dist);
+                throw;
+            }
+            size_ = new_size;
+            if (!has_room) {
+                FinishProbe(probe, VectorEventKind::GROW, false);
+            }
+            return data_ + dist;
+        }
+    }
+    RawMemory<T, Allocator> new_data(GrowthCapacity(new_size), data_.GetAllocator());
+    std::uninitialized_copy_n(first, count, new_data + dist);
+    try {
+        UninitializedRelocate(data_.GetAddress(), dist, new_data.GetAddress());
+    } catch (...) {
+        std::destroy_n(new_data + dist, count);
+        throw;
+    }
+    try {
+        UninitializedRelocate(data_ + dist, old_size - dist, new_data + (dist + count));
+    } catch (...) {
+        std::destroy_n(new_data.GetAddress(), dist + count);
+        throw;
+    }
+    DestroyRelocated(data_.GetAddress(), old_size);
+    data_.Swap(new_data);
+    size_ = new_size;
+    FinishProbe(probe, VectorEventKind::GROW, true);
     return data_ + dist;
 }
 
-template<typename T>
-size_t Vector<T>::Size() const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Erase(const const_iterator pos) {
+    const size_t dist = pos - cbegin();
+    EraseShifting(data_.GetAddress(), size_, dist);
+    --size_;
+    MaybeShrink();
+    return data_ + dist;
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::iterator Vector<T, Allocator, GrowthPolicy, Instrumentation>::Erase(const const_iterator first, const const_iterator last) {
+    const size_t dist = first - cbegin();
+    const size_t count = last - first;
+    if (count == 0U) {
+        return data_ + dist;
+    }
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        std::destroy_n(data_ + dist, count);
+        RelocateBitwiseOverlapping(data_ + (dist + count), size_ - (dist + count), data_ + dist);
+    } else {
+        std::move(data_ + (dist + count), data_ + size_, data_ + dist);
+        std::destroy_n(data_ + (size_ - count), count);
+    }
+    size_ -= count;
+    MaybeShrink();
+    return data_ + dist;
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <typename Predicate>
+size_t Vector<T, Allocator, GrowthPolicy, Instrumentation>::EraseIf(Predicate pred) {
+    const size_t old_size = size_;
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        // Стёртые элементы уничтожаются сразу, оставшиеся побайтово переносятся на их место
+        size_t write = 0U;
+        size_t read = 0U;
+        try {
+            for (; read < old_size; ++read) {
+                if (pred(std::as_const(data_[read]))) {
+                    std::destroy_at(data_ + read);
+                } else {
+                    if (write != read) {
+                        RelocateBitwise(data_ + read, 1U, data_ + write);
+                    }
+                    ++write;
+                }
+            }
+        } catch (...) {
+            RelocateBitwiseOverlapping(data_ + read, old_size - read, data_ + write);
+            size_ = write + (old_size - read);
+            throw;
+        }
+        size_ = write;
+    } else {
+        const iterator new_end = std::remove_if(begin(), end(), [&pred](const T& item) {
+            return pred(item);
+        });
+        std::destroy(new_end, end());
+        size_ = new_end - begin();
+    }
+    MaybeShrink();
+    return old_size - size_;
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+template <std::ranges::input_range IndexRange>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::EraseIndices(const IndexRange& sorted_indices) {
+    // Отрезок [read, index) сохраняется и сдвигается к write, элемент index стирается
+    size_t write = 0U;
+    size_t read = 0U;
+    for (const auto raw_index : sorted_indices) {
+        const auto index = static_cast<size_t>(raw_index);
+        assert(index >= read && index < size_);
+        if (write != read) {
+            if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+                RelocateBitwiseOverlapping(data_ + read, index - read, data_ + write);
+            } else {
+                std::move(data_ + read, data_ + index, data_ + write);
+            }
+        }
+        write += index - read;
+        if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+            std::destroy_at(data_ + index);
+        }
+        read = index + 1U;
+    }
+    if (write == read) {
+        return;
+    }
+    if constexpr (IS_TRIVIALLY_RELOCATABLE<T>) {
+        RelocateBitwiseOverlapping(data_ + read, size_ - read, data_ + write);
+    } else {
+        std::move(data_ + read, data_ + size_, data_ + write);
+        std::destroy_n(data_ + (write + size_ - read), read - write);
+    }
+    size_ = write + (size_ - read);
+    MaybeShrink();
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+size_t Vector<T, Allocator, GrowthPolicy, Instrumentation>::Size() const noexcept {
     return size_;
 }
 
-template<typename T>
-size_t Vector<T>::Capacity() const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+size_t Vector<T, Allocator, GrowthPolicy, Instrumentation>::Capacity() const noexcept {
     return data_.Capacity();
 }
 
-template<typename T>
-const T& Vector<T>::operator[](const size_t index) const noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+const T& Vector<T, Allocator, GrowthPolicy, Instrumentation>::operator[](const size_t index) const noexcept {
     return const_cast<Vector&>(*this)[index];
 }
 
-template<typename T>
-T& Vector<T>::operator[](const size_t index) noexcept {
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+T& Vector<T, Allocator, GrowthPolicy, Instrumentation>::operator[](const size_t index) noexcept {
     assert(index < size_);
     return data_[index];
 }
 
-template<typename T>
-void Vector<T>::Reallocate(T *const from, const size_t n, T *const to) {
-    if constexpr (std::is_nothrow_move_constructible_v<T> || (!std::is_copy_constructible_v<T>)) {
-        std::uninitialized_move_n(from, n, to);
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+Allocator Vector<T, Allocator, GrowthPolicy, Instrumentation>::GetAllocator() const noexcept {
+    return data_.GetAllocator();
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+size_t Vector<T, Allocator, GrowthPolicy, Instrumentation>::NextCapacity() const noexcept {
+    return GrowthPolicy::NextCapacity(data_.Capacity(), size_ + 1U, sizeof(T));
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::ReserveImpl(const size_t new_capacity, const VectorEventKind kind) {
+    if (new_capacity <= data_.Capacity()) {
+        return;
+    }
+    const GrowthProbe probe = StartProbe();
+    bool relocated = false;
+    if (data_.TryExpand(new_capacity)) {
+        // Буфер расширен на месте
+    } else if constexpr (GROW_IN_PLACE) {
+        data_.Reallocate(new_capacity);
     } else {
-        std::uninitialized_copy_n(from, n, to);
+        RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+        UninitializedRelocate(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocated(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+        relocated = true;
     }
+    FinishProbe(probe, kind, relocated);
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::ResizeZeroFilled(const size_t new_size) {
+    if constexpr (ZERO_FILLED_ALLOCATION) {
+        const GrowthProbe probe = StartProbe();
+        RawMemory<T, Allocator> new_data(new_size, ZERO_FILLED, data_.GetAllocator());
+        RelocateBitwise(data_.GetAddress(), size_, new_data.GetAddress());
+        data_.Swap(new_data);
+        FinishProbe(probe, VectorEventKind::RESIZE, true);
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::ShrinkImpl(const size_t new_capacity) {
+    assert(new_capacity >= size_);
+    if (new_capacity >= data_.Capacity()) {
+        return;
+    }
+    const GrowthProbe probe = StartProbe();
+    if constexpr (GROW_IN_PLACE) {
+        data_.Reallocate(new_capacity);
+        FinishProbe(probe, VectorEventKind::SHRINK, false);
+    } else {
+        RawMemory<T, Allocator> new_data(new_capacity, data_.GetAllocator());
+        UninitializedRelocate(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyRelocated(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+        FinishProbe(probe, VectorEventKind::SHRINK, true);
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::MaybeShrink() noexcept {
+    if constexpr (AUTO_SHRINK) {
+        const size_t new_capacity = GrowthPolicy::ShrinkCapacity(data_.Capacity(), size_, sizeof(T));
+        if (new_capacity < data_.Capacity()) {
+            try {
+                ShrinkImpl(new_capacity);
+            } catch (...) {
+                // Память не освободилась, но вектор остался прежним
+            }
+        }
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+typename Vector<T, Allocator, GrowthPolicy, Instrumentation>::GrowthProbe
+Vector<T, Allocator, GrowthPolicy, Instrumentation>::StartProbe(const std::source_location& site) const noexcept {
+    if constexpr (Instrumentation::ENABLED) {
+        return GrowthProbe{data_.Capacity(), size_, std::chrono::steady_clock::now(), site};
+    } else {
+        return GrowthProbe{};
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+void Vector<T, Allocator, GrowthPolicy, Instrumentation>::FinishProbe(const GrowthProbe& probe,
+                                                                      const VectorEventKind kind,
+                                                                      const bool relocated) const noexcept {
+    if constexpr (Instrumentation::ENABLED) {
+        const auto elapsed = std::chrono::steady_clock::now() - probe.start;
+        const size_t bytes_moved = relocated ? probe.size * sizeof(T) : 0U;
+        Instrumentation::OnEvent(VectorEvent{kind, this, sizeof(T), probe.capacity, data_.Capacity(), bytes_moved,
+                                             std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed),
+                                             probe.site});
+    }
+}
+
+template<typename T, typename Allocator, typename GrowthPolicy, typename Instrumentation>
+size_t Vector<T, Allocator, GrowthPolicy, Instrumentation>::GrowthCapacity(const size_t required) const noexcept {
+    return GrowthPolicy::NextCapacity(data_.Capacity(), required, sizeof(T));
 }
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <source_location>
+
+/**
+ * @brief Событие, о котором Vector сообщает инструментированию.
+ */
+enum class VectorEventKind {
+    RESERVE, //!< Вместимость увеличена вызовом Reserve.
+    GROW, //!< Вместимость увеличена при вставке в EmplaceBack или Emplace.
+    RESIZE, //!< Вместимость увеличена вызовом Resize.
+    SHRINK, //!< Вместимость уменьшена вызовом ShrinkToFit или стратегией роста.
+    DESTROY, //!< Вектор уничтожен вместе с памятью.
+};
+
+/**
+ * @brief Сведения о смене вместимости вектора.
+ */
+struct VectorEvent {
+    VectorEventKind kind; //!< Событие.
+    const void *container; //!< Адрес вектора.
+    size_t element_size; //!< Размер элемента в байтах.
+    size_t old_capacity; //!< Вместимость до события.
+    size_t new_capacity; //!< Вместимость после события, 0 при уничтожении.
+    //! Байты элементов, которые вектор перенёс в новый буфер; 0 при росте на месте и при
+    //! Reallocate аллокатора, который может обойтись без копирования (mremap).
+    size_t bytes_moved;
+    std::chrono::nanoseconds elapsed; //!< Длительность смены буфера вместе с переносом.
+    //! Место вызова вставки, вызвавшей рост; пустое, если оно неизвестно.
+    std::source_location site;
+};
+
+/**
+ * @brief Место вызова, передаваемое явно первым аргументом EmplaceBack и Emplace.
+ * @details У функций с переменным числом аргументов не может быть аргумента по умолчанию
+ * в конце, поэтому место вызова передаётся так: v.EmplaceBack(CallSite{}, args...).
+ * Инициализатор члена вычисляется в месте создания CallSite, то есть в вызывающем коде.
+ */
+struct CallSite {
+    std::source_location location = std::source_location::current(); //!< Место вызова.
+};
+
+/**
+ * @brief Требования к инструментированию Vector.
+ * @details ENABLED == false выключает инструментирование во время компиляции: Vector
+ * не замеряет время и не вызывает OnEvent, так что код не отличается от неинструментированного.
+ */
+template <typename Instrumentation>
+concept VectorInstrumentation = requires(const VectorEvent &event) {
+    { Instrumentation::ENABLED } -> std::convertible_to<bool>;
+    { Instrumentation::OnEvent(event) } noexcept;
+};
+
+/**
+ * @brief Инструментирование по умолчанию: ничего не делает и ничего не стоит.
+ */
+struct NoInstrumentation {
+    static constexpr bool ENABLED = false; //!< Инструментирование выключено.
+
+    //! Ничего не делает.
+    static void OnEvent(const VectorEvent & /*event*/) noexcept {
+    }
+};